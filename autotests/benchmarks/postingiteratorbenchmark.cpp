@@ -0,0 +1,134 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "andpostingiterator.h"
+#include "vectorpostingiterator.h"
+
+#include <QTest>
+
+using namespace Baloo;
+
+namespace {
+/*
+ * Hides the skipTo override of the wrapped iterator, so the
+ * intersection falls back to the linear PostingIterator::skipTo
+ */
+class LinearPostingIterator : public PostingIterator
+{
+public:
+    explicit LinearPostingIterator(const QVector<quint64>& values)
+        : m_it(values)
+    {
+    }
+
+    quint64 docId() const override {
+        return m_it.docId();
+    }
+    quint64 next() override {
+        return m_it.next();
+    }
+
+private:
+    VectorPostingIterator m_it;
+};
+}
+
+class PostingIteratorBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    // intersection of a rare term with a common one
+    void benchAndSkewed_data();
+    void benchAndSkewed();
+    // both lists of the same size
+    void benchAndBalanced_data();
+    void benchAndBalanced();
+};
+
+static QVector<quint64> createList(int size, quint64 step)
+{
+    QVector<quint64> list;
+    list.reserve(size);
+    for (int i = 1; i <= size; i++) {
+        list.append(i * step);
+    }
+    return list;
+}
+
+void PostingIteratorBenchmark::benchAndSkewed_data()
+{
+    QTest::addColumn<int>("rareSize");
+    QTest::addColumn<int>("commonSize");
+    QTest::addColumn<bool>("galloping");
+
+    for (int commonSize : {10000, 100000, 1000000}) {
+        for (bool galloping : {false, true}) {
+            const QByteArray name = QByteArray::number(commonSize) + (galloping ? " galloping" : " linear");
+            QTest::newRow(name.constData()) << 100 << commonSize << galloping;
+        }
+    }
+}
+
+void PostingIteratorBenchmark::benchAndSkewed()
+{
+    QFETCH(int, rareSize);
+    QFETCH(int, commonSize);
+    QFETCH(bool, galloping);
+
+    // Spread the rare ids over the whole range of the common list
+    const QVector<quint64> rare = createList(rareSize, 2 * commonSize / rareSize);
+    const QVector<quint64> common = createList(commonSize, 2);
+
+    QBENCHMARK {
+        PostingIterator* rareIt = new VectorPostingIterator(rare);
+        PostingIterator* commonIt = galloping ? static_cast<PostingIterator*>(new VectorPostingIterator(common))
+                                              : new LinearPostingIterator(common);
+        AndPostingIterator it({commonIt, rareIt});
+        int count = 0;
+        while (it.next()) {
+            count++;
+        }
+        QCOMPARE(count, rareSize);
+    }
+}
+
+void PostingIteratorBenchmark::benchAndBalanced_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("galloping");
+
+    QTest::newRow("linear") << 100000 << false;
+    QTest::newRow("galloping") << 100000 << true;
+}
+
+void PostingIteratorBenchmark::benchAndBalanced()
+{
+    QFETCH(int, size);
+    QFETCH(bool, galloping);
+
+    const QVector<quint64> l1 = createList(size, 2);
+    const QVector<quint64> l2 = createList(size, 3);
+
+    QBENCHMARK {
+        PostingIterator* it1;
+        PostingIterator* it2;
+        if (galloping) {
+            it1 = new VectorPostingIterator(l1);
+            it2 = new VectorPostingIterator(l2);
+        } else {
+            it1 = new LinearPostingIterator(l1);
+            it2 = new LinearPostingIterator(l2);
+        }
+        AndPostingIterator it({it1, it2});
+        while (it.next()) {
+        }
+    }
+}
+
+QTEST_MAIN(PostingIteratorBenchmark)
+
+#include "postingiteratorbenchmark.moc"
@@ -0,0 +1,174 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "bulkloader.h"
+#include "dbstate.h"
+#include "database.h"
+#include "idutils.h"
+
+#include <QDir>
+#include <QTest>
+#include <QTemporaryDir>
+
+using namespace Baloo;
+
+class BulkLoaderTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init() {
+        dir = std::make_unique<QTemporaryDir>();
+        m_dirId = filePathToId(QFile::encodeName(dir->path()));
+        QVERIFY(m_dirId);
+    }
+
+    void cleanup() {
+        dir.reset();
+    }
+
+    void testSameAsAddDocument();
+    void testTransactionReset();
+    void testRunDirectory();
+
+private:
+    QVector<Document> createDocuments(int count) const;
+
+    std::unique_ptr<QTemporaryDir> dir;
+    quint64 m_dirId = 0;
+};
+
+QVector<Document> BulkLoaderTest::createDocuments(int count) const
+{
+    QVector<Document> docs;
+    for (int i = 0; i < count; i++) {
+        Document doc;
+        // Add the documents out of id order
+        doc.setId(m_dirId + 1 + (i * 7919) % count);
+        doc.setParentId(m_dirId);
+        doc.setUrl(QFile::encodeName(dir->path() + QStringLiteral("/file") + QString::number(i)));
+
+        doc.addTerm("Mtext/plain");
+        doc.addPositionTerm("common", 1);
+        doc.addPositionTerm("term" + QByteArray::number(i % 13), 2);
+        doc.addPositionTerm("term" + QByteArray::number(i % 13), 5);
+        if (i % 3 == 0) {
+            doc.addTerm("three");
+        }
+        doc.addFileNamePositionTerm("file", 1);
+        doc.addFileNamePositionTerm(QByteArray::number(i), 2);
+        if (i % 5 == 0) {
+            doc.addXattrTerm("tag");
+        }
+        doc.setMTime(i);
+        doc.setCTime(i);
+        docs << doc;
+    }
+    return docs;
+}
+
+void BulkLoaderTest::testSameAsAddDocument()
+{
+    // More documents than fit into a single chunk
+    const QVector<Document> docs = createDocuments(5000);
+
+    Database db(dir->path() + QStringLiteral("/db"));
+    QVERIFY(db.open(Database::CreateDatabase));
+    {
+        Transaction tr(db, Transaction::ReadWrite);
+        for (const Document& doc : docs) {
+            tr.addDocument(doc);
+        }
+        QVERIFY(tr.commit());
+    }
+
+    Database bulkDb(dir->path() + QStringLiteral("/bulkdb"));
+    QVERIFY(bulkDb.open(Database::CreateDatabase));
+    {
+        // A small budget, so the terms are spread over many runs, and
+        // written in many transactions
+        BulkLoader loader(BulkLoader::runDirectory(bulkDb.path()), 16 * 1024, 16 * 1024);
+        QVERIFY(loader.isValid());
+
+        Transaction tr(bulkDb, Transaction::ReadWrite);
+        tr.setBulkLoader(&loader);
+        for (const Document& doc : docs) {
+            tr.addDocument(doc);
+        }
+        QVERIFY(tr.finishBulkLoad());
+        QVERIFY(tr.commit());
+    }
+
+    Transaction tr(db, Transaction::ReadOnly);
+    Transaction bulkTr(bulkDb, Transaction::ReadOnly);
+    QVERIFY(DBState::debugCompare(DBState::fromTransaction(&bulkTr), DBState::fromTransaction(&tr)));
+    QCOMPARE(bulkTr.size(), 5000u);
+}
+
+void BulkLoaderTest::testTransactionReset()
+{
+    const QVector<Document> docs = createDocuments(100);
+
+    Database db(dir->path());
+    QVERIFY(db.open(Database::CreateDatabase));
+
+    BulkLoader loader(BulkLoader::runDirectory(db.path()));
+    Transaction tr(db, Transaction::ReadWrite);
+    tr.setBulkLoader(&loader);
+    for (int i = 0; i < docs.size(); i++) {
+        tr.addDocument(docs[i]);
+        if (i % 30 == 0) {
+            QVERIFY(tr.commit());
+            tr.reset(Transaction::ReadWrite);
+        }
+    }
+    QVERIFY(tr.commit());
+
+    {
+        // Nothing has been written to the term databases yet
+        Transaction readTr(db, Transaction::ReadOnly);
+        QCOMPARE(readTr.size(), 0u);
+        QVERIFY(readTr.hasDocument(docs.first().id()));
+    }
+
+    tr.reset(Transaction::ReadWrite);
+    QVERIFY(tr.finishBulkLoad());
+    QVERIFY(tr.commit());
+
+    Transaction readTr(db, Transaction::ReadOnly);
+    QCOMPARE(readTr.size(), 100u);
+    DBState state = DBState::fromTransaction(&readTr);
+    QCOMPARE(state.postingDb.value("common").size(), 100);
+    QCOMPARE(state.postingDb.value("tag").size(), 20);
+}
+
+void BulkLoaderTest::testRunDirectory()
+{
+    const QString runDir = BulkLoader::runDirectory(dir->path());
+    {
+        BulkLoader loader(runDir, 1024);
+        QVERIFY(loader.isValid());
+        QVERIFY(QFile::exists(runDir));
+
+        const QVector<Document> docs = createDocuments(100);
+        for (const Document& doc : docs) {
+            loader.addDocument(doc);
+        }
+        QVERIFY(!QDir(runDir).isEmpty());
+    }
+
+    // The runs are gone, but the directory marks the unfinished bulk load
+    QVERIFY(QFile::exists(runDir));
+    QVERIFY(QDir(runDir).isEmpty());
+
+    BulkLoader loader(runDir);
+    loader.removeRunDirectory();
+    QVERIFY(!QFile::exists(runDir));
+}
+
+QTEST_MAIN(BulkLoaderTest)
+
+#include "bulkloadertest.moc"
@@ -37,11 +37,14 @@ private Q_SLOTS:
     void testAddAndRemoveOneDocument();
     void testAddAndReplaceOneDocument();
     void testIdempotentDocumentChange();
+    void testAddAndRemoveManyDocuments();
+    void testMemoryBudget();
 
     void testRemoveRecursively();
     void testDocumentId();
     void testTermPositions();
     void testTransactionReset();
+    void testFolderTimeInfo();
 private:
     std::unique_ptr<QTemporaryDir> dir;
     std::unique_ptr<Database> db;
@@ -454,6 +457,86 @@ void WriteTransactionTest::testIdempotentDocumentChange()
     }
 }
 
+void WriteTransactionTest::testAddAndRemoveManyDocuments()
+{
+    QVector<Document> docs;
+    for (int i = 0; i < 300; i++) {
+        const QString url(dir->path() + QStringLiteral("/file") + QString::number(i));
+        const QByteArray parity = (i % 2) ? QByteArray("odd") : QByteArray("even");
+        docs << createDocument(url, 5, 1, {"common", parity}, {"file"}, {}, m_dirId);
+    }
+
+    {
+        Transaction tr(db.get(), Transaction::ReadWrite);
+        for (const Document& doc : std::as_const(docs)) {
+            tr.addDocument(doc);
+        }
+        // Remove some of the documents again before committing
+        for (int i = 0; i < docs.size(); i += 3) {
+            tr.removeDocument(docs[i].id());
+        }
+        tr.commit();
+    }
+
+    PostingList common;
+    PostingList odd;
+    PostingList even;
+    for (int i = 0; i < docs.size(); i++) {
+        if (i % 3 == 0) {
+            continue;
+        }
+        common << docs[i].id();
+        if (i % 2) {
+            odd << docs[i].id();
+        } else {
+            even << docs[i].id();
+        }
+    }
+
+    Transaction tr(db.get(), Transaction::ReadOnly);
+    DBState actualState = DBState::fromTransaction(&tr);
+    QCOMPARE(actualState.postingDb.value("common"), common);
+    QCOMPARE(actualState.postingDb.value("file"), common);
+    QCOMPARE(actualState.postingDb.value("odd"), odd);
+    QCOMPARE(actualState.postingDb.value("even"), even);
+}
+
+void WriteTransactionTest::testMemoryBudget()
+{
+    QVector<Document> docs;
+    for (int i = 0; i < 100; i++) {
+        const QString url(dir->path() + QStringLiteral("/file") + QString::number(i));
+        docs << createDocument(url, 5, 1, {"common", QByteArray::number(i % 7)}, {"file"}, {}, m_dirId);
+    }
+
+    PostingList common;
+    for (int i = 1; i < docs.size(); i += 2) {
+        common << docs[i].id();
+    }
+
+    {
+        Transaction tr(db.get(), Transaction::ReadWrite);
+        // Write the pending changes after every document
+        tr.setMemoryBudget(1);
+        for (const Document& doc : std::as_const(docs)) {
+            tr.addDocument(doc);
+        }
+        for (int i = 0; i < docs.size(); i += 2) {
+            tr.removeDocument(docs[i].id());
+        }
+
+        // The changes have been written before the commit
+        DBState state = DBState::fromTransaction(&tr);
+        QCOMPARE(state.postingDb.value("common"), common);
+        tr.commit();
+    }
+
+    Transaction tr(db.get(), Transaction::ReadOnly);
+    DBState state = DBState::fromTransaction(&tr);
+    QCOMPARE(state.postingDb.value("common"), common);
+    QCOMPARE(state.postingDb.value("file"), common);
+}
+
 void WriteTransactionTest::testTransactionReset()
 {
     const QString url1(dir->path() + QStringLiteral("/file1"));
@@ -478,6 +561,32 @@ void WriteTransactionTest::testTransactionReset()
     tr.commit();
 }
 
+void WriteTransactionTest::testFolderTimeInfo()
+{
+    const QString url1(dir->path() + QStringLiteral("/file1"));
+    const QString url2(dir->path() + QStringLiteral("/file2"));
+
+    Document doc1 = createDocument(url1, 5, 1, {"a"}, {"file1"}, {}, m_dirId);
+    Document doc2 = createDocument(url2, 6, 2, {"b"}, {"file2"}, {}, m_dirId);
+
+    Transaction tr(db.get(), Transaction::ReadWrite);
+    tr.addDocument(doc2);
+    tr.addDocument(doc1);
+    tr.commit();
+
+    Transaction tr2(db.get(), Transaction::ReadOnly);
+    QVector<quint64> ids;
+    QVector<DocumentTimeDB::TimeInfo> timeInfos;
+    tr2.folderTimeInfo(m_dirId, ids, timeInfos);
+    QCOMPARE(ids, QVector<quint64>({doc1.id(), doc2.id()}));
+    QCOMPARE(timeInfos, QVector<DocumentTimeDB::TimeInfo>({DocumentTimeDB::TimeInfo(5, 1), DocumentTimeDB::TimeInfo(6, 2)}));
+
+    // The folder itself is not indexed
+    tr2.folderTimeInfo(doc1.id(), ids, timeInfos);
+    QVERIFY(ids.isEmpty());
+    QVERIFY(timeInfos.isEmpty());
+}
+
 QTEST_MAIN(WriteTransactionTest)
 
 #include "writetransactiontest.moc"
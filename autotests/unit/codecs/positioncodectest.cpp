@@ -23,6 +23,7 @@ private Q_SLOTS:
     void checkEncodeOutput();
     void checkEncodeOutput2();
     void checkEncodeOutput3();
+    void checkListReader();
 private:
     QVector<PositionInfo> m_data;
     QVector<PositionInfo> m_data2;
@@ -103,4 +104,22 @@ void PositionCodecTest::checkEncodeOutput3()
     QCOMPARE(m_data3, decodedData);
 }
 
+void PositionCodecTest::checkListReader()
+{
+    const QByteArray ba = PositionCodec::encode(m_data);
+    PositionListReader reader(ba.constData(), ba.size());
+
+    for (int i = 0; i < m_data.size(); i++) {
+        QCOMPARE(reader.next(), m_data[i].docId);
+        QCOMPARE(reader.docId(), m_data[i].docId);
+        // Positions of skipped entries are never decoded
+        if (i % 2) {
+            QCOMPARE(reader.positions(), m_data[i].positions);
+        }
+    }
+    QCOMPARE(reader.next(), static_cast<quint64>(0));
+    QCOMPARE(reader.docId(), static_cast<quint64>(0));
+    QVERIFY(reader.positions().isEmpty());
+}
+
 #include "positioncodectest.moc"
@@ -24,6 +24,71 @@ private Q_SLOTS:
         QVector<quint64> vec2 = PostingCodec::decode(arr);
         QCOMPARE(vec2, vec);
     }
+
+    void testLargeIds() {
+        QVector<quint64> vec = {1, 0x00000100000002ULL, 0x7fffffff00000001ULL, 0xffffffffffffffffULL};
+        QByteArray arr = PostingCodec::encode(vec);
+
+        QVector<quint64> vec2 = PostingCodec::decode(arr);
+        QCOMPARE(vec2, vec);
+    }
+
+    void testDenseList() {
+        QVector<quint64> vec;
+        for (quint64 id = 1000; id < 11000; id++) {
+            vec << id;
+        }
+        QByteArray arr = PostingCodec::encode(vec);
+        // One byte per id, plus header and block directory
+        QVERIFY(arr.size() < vec.size() + 16 * (vec.size() / PostingCodec::BlockSize + 1));
+
+        QVector<quint64> vec2 = PostingCodec::decode(arr);
+        QCOMPARE(vec2, vec);
+    }
+
+    void testBlockReader() {
+        QVector<quint64> vec;
+        for (quint64 id = 1; id <= 1000; id++) {
+            vec << id * 3;
+        }
+        QByteArray arr = PostingCodec::encode(vec);
+
+        PostingBlockReader reader(arr.constData(), arr.size());
+        QVERIFY(reader.isValid());
+        QCOMPARE(reader.size(), static_cast<quint64>(1000));
+        QCOMPARE(reader.blockCount(), 8);
+
+        // 3 * 128 is the last id of block 0
+        QCOMPARE(reader.findBlock(3 * 128, 0), 0);
+        QCOMPARE(reader.findBlock(3 * 128 + 1, 0), 1);
+        QCOMPARE(reader.findBlock(1, 5), 5);
+        QCOMPARE(reader.findBlock(3000, 0), 7);
+        QCOMPARE(reader.findBlock(3001, 0), 8);
+
+        quint64 ids[PostingCodec::BlockSize];
+        QCOMPARE(reader.decodeBlock(1, ids), PostingCodec::BlockSize);
+        QCOMPARE(ids[0], static_cast<quint64>(3 * 129));
+        QCOMPARE(reader.decodeBlock(7, ids), 1000 - 7 * PostingCodec::BlockSize);
+        QCOMPARE(ids[0], static_cast<quint64>(3 * (7 * 128 + 1)));
+    }
+
+    void testEmpty() {
+        QByteArray arr = PostingCodec::encode({});
+        QVERIFY(PostingCodec::decode(arr).isEmpty());
+        QVERIFY(PostingCodec::decode(QByteArray()).isEmpty());
+    }
+
+    void testCorrupt() {
+        QVector<quint64> vec = {1, 2, 9, 12};
+        QByteArray arr = PostingCodec::encode(vec);
+
+        // truncated
+        QVERIFY(PostingCodec::decode(arr.left(arr.size() - 1)).isEmpty());
+
+        // unknown format version
+        arr[0] = PostingCodec::FormatVersion + 1;
+        QVERIFY(PostingCodec::decode(arr).isEmpty());
+    }
 };
 
 QTEST_MAIN(PostingCodecTest)
@@ -18,6 +18,8 @@ class AndPostingIteratorTest : public QObject
 private Q_SLOTS:
     void test();
     void testNullIterators();
+    void testEmptyIterators();
+    void testEstimatedSize();
 };
 
 void AndPostingIteratorTest::test()
@@ -59,6 +61,47 @@ void AndPostingIteratorTest::testNullIterators()
     QCOMPARE(it.docId(), static_cast<quint64>(0));
 }
 
+void AndPostingIteratorTest::testEmptyIterators()
+{
+    QVector<quint64> l1 = {1, 3, 5, 7};
+
+    VectorPostingIterator* it1 = new VectorPostingIterator(l1);
+    VectorPostingIterator* it2 = new VectorPostingIterator({});
+
+    QVector<PostingIterator*> vec = {it1, it2};
+
+    AndPostingIterator it(vec);
+    QCOMPARE(it.estimatedSize(), static_cast<quint64>(0));
+    QCOMPARE(it.next(), static_cast<quint64>(0));
+    QCOMPARE(it.docId(), static_cast<quint64>(0));
+}
+
+void AndPostingIteratorTest::testEstimatedSize()
+{
+    QVector<quint64> l1;
+    for (quint64 id = 1; id < 1000; id++) {
+        l1 << id;
+    }
+    QVector<quint64> l2 = {3, 500, 999, 2000};
+
+    // The order of the sub iterators must not change the result
+    for (bool rareFirst : {false, true}) {
+        VectorPostingIterator* it1 = new VectorPostingIterator(l1);
+        VectorPostingIterator* it2 = new VectorPostingIterator(l2);
+
+        QVector<PostingIterator*> vec = rareFirst ? QVector<PostingIterator*>{it2, it1} : QVector<PostingIterator*>{it1, it2};
+        AndPostingIterator it(vec);
+        QCOMPARE(it.estimatedSize(), static_cast<quint64>(4));
+
+        QVector<quint64> result = {3, 500, 999};
+        for (quint64 val : result) {
+            QCOMPARE(it.next(), static_cast<quint64>(val));
+            QCOMPARE(it.docId(), static_cast<quint64>(val));
+        }
+        QCOMPARE(it.next(), static_cast<quint64>(0));
+    }
+}
+
 QTEST_MAIN(AndPostingIteratorTest)
 
 #include "andpostingiteratortest.moc"
@@ -0,0 +1,111 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "contenthashdb.h"
+#include "dbtest.h"
+
+using namespace Baloo;
+
+class ContentHashDBTest : public DBTest
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPutGet();
+    void testCopies();
+    void testDel();
+    void testPrefix();
+    void testWithoutDb();
+};
+
+void ContentHashDBTest::testPutGet()
+{
+    ContentHashDB db(ContentHashDB::createIdHashDb(m_txn), ContentHashDB::createHashIdDb(m_txn), m_txn);
+
+    db.put(1, QByteArray("hash1"));
+    QCOMPARE(db.get(1), QByteArray("hash1"));
+    QCOMPARE(db.documentWithHash(QByteArray("hash1")), quint64(1));
+
+    db.put(1, QByteArray("hash2"));
+    QCOMPARE(db.get(1), QByteArray("hash2"));
+    QCOMPARE(db.documentWithHash(QByteArray("hash1")), quint64(0));
+    QCOMPARE(db.documentWithHash(QByteArray("hash2")), quint64(1));
+
+    db.put(1, QByteArray());
+    QVERIFY(db.get(1).isEmpty());
+    QVERIFY(db.toTestMap().isEmpty());
+}
+
+void ContentHashDBTest::testCopies()
+{
+    ContentHashDB db(ContentHashDB::createIdHashDb(m_txn), ContentHashDB::createHashIdDb(m_txn), m_txn);
+
+    db.put(1, QByteArray("hash"));
+    db.put(2, QByteArray("hash"));
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(2));
+
+    // The older copy does not remove the hash
+    db.del(1);
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(2));
+
+    QMap<quint64, QByteArray> expected;
+    expected.insert(2, QByteArray("hash"));
+    QCOMPARE(db.toTestMap(), expected);
+
+    // Neither does the newest one
+    db.put(1, QByteArray("hash"));
+    db.put(3, QByteArray("hash"));
+    db.del(3);
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(2));
+    db.put(2, QByteArray("other"));
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(1));
+    QCOMPARE(db.documentWithHash(QByteArray("other")), quint64(2));
+    db.del(1);
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(0));
+}
+
+void ContentHashDBTest::testDel()
+{
+    ContentHashDB db(ContentHashDB::createIdHashDb(m_txn), ContentHashDB::createHashIdDb(m_txn), m_txn);
+
+    db.put(1, QByteArray("hash"));
+    db.del(1);
+    QVERIFY(db.get(1).isEmpty());
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(0));
+
+    // Removing a document without a hash is fine
+    db.del(2);
+}
+
+void ContentHashDBTest::testPrefix()
+{
+    ContentHashDB db(ContentHashDB::createIdHashDb(m_txn), ContentHashDB::createHashIdDb(m_txn), m_txn);
+
+    db.put(1, QByteArray("size1"));
+    db.put(2, QByteArray("size2hash"));
+    QVERIFY(db.hasHashWithPrefix(QByteArray("size1")));
+    QVERIFY(db.hasHashWithPrefix(QByteArray("size2")));
+    QVERIFY(!db.hasHashWithPrefix(QByteArray("size3")));
+    QVERIFY(!db.hasHashWithPrefix(QByteArray("size10")));
+
+    db.del(2);
+    QVERIFY(!db.hasHashWithPrefix(QByteArray("size2")));
+}
+
+void ContentHashDBTest::testWithoutDb()
+{
+    ContentHashDB db(0, 0, m_txn);
+
+    db.put(1, QByteArray("hash"));
+    QVERIFY(db.get(1).isEmpty());
+    QCOMPARE(db.documentWithHash(QByteArray("hash")), quint64(0));
+    QVERIFY(!db.hasHashWithPrefix(QByteArray("hash")));
+    db.del(1);
+}
+
+QTEST_MAIN(ContentHashDBTest)
+
+#include "contenthashdbtest.moc"
@@ -0,0 +1,113 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "contentindexingqueuedb.h"
+#include "document.h"
+#include "documentiddb.h"
+#include "documenttimedb.h"
+#include "dbtest.h"
+
+using namespace Baloo;
+
+class ContentIndexingQueueDBTest : public DBTest
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFetchItems();
+    void testChangePriority();
+    void testDel();
+    void testRebuild();
+    void testWithoutQueue();
+};
+
+void ContentIndexingQueueDBTest::testFetchItems()
+{
+    DocumentIdDB idDb(DocumentIdDB::create("foo", m_txn), m_txn);
+    ContentIndexingQueueDB db(DocumentIdDB::create("foo", m_txn), ContentIndexingQueueDB::create(m_txn), m_txn);
+
+    db.put(1, 30);
+    db.put(2, 10);
+    db.put(3, 20);
+    db.put(4, 10);
+
+    QCOMPARE(db.fetchItems(10), QVector<quint64>({2, 4, 3, 1}));
+    QCOMPARE(db.fetchItems(2), QVector<quint64>({2, 4}));
+    QCOMPARE(idDb.size(), 4u);
+    QVERIFY(db.isComplete());
+}
+
+void ContentIndexingQueueDBTest::testChangePriority()
+{
+    ContentIndexingQueueDB db(DocumentIdDB::create("foo", m_txn), ContentIndexingQueueDB::create(m_txn), m_txn);
+
+    db.put(1, 10);
+    db.put(2, 20);
+    db.put(2, 5);
+    db.put(1, 10);
+
+    QCOMPARE(db.toTestVector(), QVector<quint64>({2, 1}));
+}
+
+void ContentIndexingQueueDBTest::testDel()
+{
+    DocumentIdDB idDb(DocumentIdDB::create("foo", m_txn), m_txn);
+    ContentIndexingQueueDB db(DocumentIdDB::create("foo", m_txn), ContentIndexingQueueDB::create(m_txn), m_txn);
+
+    db.put(1, 10);
+    db.put(2, 20);
+    db.del(1);
+    db.del(3);
+
+    QCOMPARE(db.toTestVector(), QVector<quint64>({2}));
+    QVERIFY(!idDb.contains(1));
+    QVERIFY(idDb.contains(2));
+}
+
+void ContentIndexingQueueDBTest::testRebuild()
+{
+    DocumentIdDB idDb(DocumentIdDB::create("foo", m_txn), m_txn);
+    DocumentTimeDB timeDb(DocumentTimeDB::create(m_txn), m_txn);
+
+    // Added without the queue, the priority follows the mtime
+    idDb.put(1);
+    idDb.put(2);
+    idDb.put(3);
+    timeDb.put(1, DocumentTimeDB::TimeInfo(100, 100));
+    timeDb.put(2, DocumentTimeDB::TimeInfo(300, 300));
+    timeDb.put(3, DocumentTimeDB::TimeInfo(200, 200));
+
+    ContentIndexingQueueDB db(DocumentIdDB::create("foo", m_txn), ContentIndexingQueueDB::create(m_txn), m_txn);
+    db.put(4, Document::defaultContentIndexingPriority(250));
+    QVERIFY(!db.isComplete());
+
+    db.rebuild(DocumentTimeDB::create(m_txn));
+    QVERIFY(db.isComplete());
+    QCOMPARE(db.fetchItems(10), QVector<quint64>({2, 4, 3, 1}));
+
+    // The priority is stored now, and the entries can be removed
+    db.del(3);
+    QCOMPARE(db.fetchItems(10), QVector<quint64>({2, 4, 1}));
+}
+
+void ContentIndexingQueueDBTest::testWithoutQueue()
+{
+    DocumentIdDB idDb(DocumentIdDB::create("foo", m_txn), m_txn);
+    ContentIndexingQueueDB db(DocumentIdDB::create("foo", m_txn), 0, m_txn);
+
+    db.put(3, 10);
+    db.put(1, 30);
+    db.put(2, 20);
+    QVERIFY(!db.isComplete());
+    QCOMPARE(db.fetchItems(10), QVector<quint64>({1, 2, 3}));
+
+    db.del(2);
+    QCOMPARE(idDb.toTestVector(), QVector<quint64>({1, 3}));
+}
+
+QTEST_MAIN(ContentIndexingQueueDBTest)
+
+#include "contentindexingqueuedbtest.moc"
@@ -16,6 +16,7 @@ class DocumentTimeDBTest : public DBTest
 private Q_SLOTS:
     void test();
     void testAllowZeroTime();
+    void testGetSorted();
 };
 
 void DocumentTimeDBTest::test()
@@ -49,6 +50,28 @@ void DocumentTimeDBTest::testAllowZeroTime()
     QCOMPARE(db.get(1), DocumentTimeDB::TimeInfo());
 }
 
+void DocumentTimeDBTest::testGetSorted()
+{
+    DocumentTimeDB db(DocumentTimeDB::create(m_txn), m_txn);
+
+    for (quint64 id = 1; id <= 1000; id++) {
+        if (id % 3) {
+            db.put(id, DocumentTimeDB::TimeInfo(id, id + 1));
+        }
+    }
+
+    const QVector<quint64> ids = {1, 2, 3, 4, 500, 501, 999, 1000, 2000};
+    const QVector<DocumentTimeDB::TimeInfo> infos = db.get(ids);
+    QCOMPARE(infos.size(), ids.size());
+    for (int i = 0; i < ids.size(); i++) {
+        QCOMPARE(infos[i], db.get(ids[i]));
+    }
+    QCOMPARE(infos[1], DocumentTimeDB::TimeInfo(2, 3));
+    QCOMPARE(infos[2], DocumentTimeDB::TimeInfo());
+
+    QVERIFY(db.get(QVector<quint64>()).isEmpty());
+}
+
 QTEST_MAIN(DocumentTimeDBTest)
 
 #include "documenttimedbtest.moc"
@@ -0,0 +1,75 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "folderfingerprintdb.h"
+#include "dbtest.h"
+
+using namespace Baloo;
+
+class FolderFingerprintDBTest : public DBTest
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPutGet();
+    void testDel();
+    void testWithoutDb();
+};
+
+void FolderFingerprintDBTest::testPutGet()
+{
+    FolderFingerprintDB db(FolderFingerprintDB::create(m_txn), m_txn);
+
+    FolderFingerprintDB::Fingerprint fingerprint;
+    QVERIFY(!db.get(1, fingerprint));
+
+    fingerprint.mTime = 5;
+    fingerprint.cTime = 6;
+    fingerprint.entryCount = 0;
+    db.put(1, fingerprint);
+
+    FolderFingerprintDB::Fingerprint stored;
+    QVERIFY(db.get(1, stored));
+    QCOMPARE(stored, fingerprint);
+
+    fingerprint.entryCount = 12;
+    db.put(1, fingerprint);
+    QVERIFY(db.get(1, stored));
+    QCOMPARE(stored, fingerprint);
+
+    QMap<quint64, FolderFingerprintDB::Fingerprint> expected;
+    expected.insert(1, fingerprint);
+    QCOMPARE(db.toTestMap(), expected);
+}
+
+void FolderFingerprintDBTest::testDel()
+{
+    FolderFingerprintDB db(FolderFingerprintDB::create(m_txn), m_txn);
+
+    db.put(1, FolderFingerprintDB::Fingerprint{1, 2, 3});
+    db.del(1);
+
+    FolderFingerprintDB::Fingerprint fingerprint;
+    QVERIFY(!db.get(1, fingerprint));
+
+    // Removing a folder without a fingerprint is fine
+    db.del(2);
+}
+
+void FolderFingerprintDBTest::testWithoutDb()
+{
+    FolderFingerprintDB db(0, m_txn);
+
+    db.put(1, FolderFingerprintDB::Fingerprint{1, 2, 3});
+    FolderFingerprintDB::Fingerprint fingerprint;
+    QVERIFY(!db.get(1, fingerprint));
+    db.del(1);
+    QVERIFY(db.toTestMap().isEmpty());
+}
+
+QTEST_MAIN(FolderFingerprintDBTest)
+
+#include "folderfingerprintdbtest.moc"
@@ -44,6 +44,26 @@ private Q_SLOTS:
             QCOMPARE(it->docId(), static_cast<quint64>(val));
         }
     }
+
+    void testIterSkipTo() {
+        IdTreeDB db(IdTreeDB::create(m_txn), m_txn);
+
+        db.set(1, {5, 6, 7, 8});
+        db.set(6, {9, 11, 19});
+        db.set(8, {13, 15});
+        db.set(13, {18});
+
+        std::unique_ptr<PostingIterator> it{db.iter(1)};
+        QVERIFY(it);
+
+        QCOMPARE(it->skipTo(10), static_cast<quint64>(11));
+        QCOMPARE(it->docId(), static_cast<quint64>(11));
+        QCOMPARE(it->skipTo(11), static_cast<quint64>(11));
+        QCOMPARE(it->next(), static_cast<quint64>(13));
+        QCOMPARE(it->skipTo(19), static_cast<quint64>(19));
+        QCOMPARE(it->skipTo(20), static_cast<quint64>(0));
+        QCOMPARE(it->docId(), static_cast<quint64>(0));
+    }
 };
 
 QTEST_MAIN(IdTreeDBTest)
@@ -18,6 +18,7 @@ class OrPostingIteratorTest : public QObject
 private Q_SLOTS:
     void test();
     void testNullIterators();
+    void testSkipTo();
 };
 
 void OrPostingIteratorTest::test()
@@ -66,6 +67,30 @@ void OrPostingIteratorTest::testNullIterators()
     QCOMPARE(it.docId(), static_cast<quint64>(0));
 }
 
+void OrPostingIteratorTest::testSkipTo()
+{
+    QVector<quint64> l1 = {1, 3, 5, 7};
+    QVector<quint64> l2 = {3, 4, 5, 7, 9, 11};
+    QVector<quint64> l3 = {1, 3, 7, 20};
+
+    VectorPostingIterator* it1 = new VectorPostingIterator(l1);
+    VectorPostingIterator* it2 = new VectorPostingIterator(l2);
+    VectorPostingIterator* it3 = new VectorPostingIterator(l3);
+
+    QVector<PostingIterator*> vec = {it1, it2, it3};
+    OrPostingIterator it(vec);
+
+    QCOMPARE(it.skipTo(2), static_cast<quint64>(3));
+    QCOMPARE(it.docId(), static_cast<quint64>(3));
+    QCOMPARE(it.skipTo(3), static_cast<quint64>(3));
+    QCOMPARE(it.next(), static_cast<quint64>(4));
+    QCOMPARE(it.skipTo(8), static_cast<quint64>(9));
+    QCOMPARE(it.next(), static_cast<quint64>(11));
+    QCOMPARE(it.skipTo(12), static_cast<quint64>(20));
+    QCOMPARE(it.next(), static_cast<quint64>(0));
+    QCOMPARE(it.docId(), static_cast<quint64>(0));
+}
+
 QTEST_MAIN(OrPostingIteratorTest)
 
 #include "orpostingiteratortest.moc"
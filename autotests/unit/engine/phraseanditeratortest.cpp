@@ -54,7 +54,7 @@ void PhraseAndIteratorTest::test()
     VectorPositionInfoIterator* it1 = new VectorPositionInfoIterator(vec1);
     VectorPositionInfoIterator* it2 = new VectorPositionInfoIterator(vec2);
 
-    QVector<VectorPositionInfoIterator*> vec = {it1, it2};
+    QVector<PositionInfoIterator*> vec = {it1, it2};
     PhraseAndIterator it(vec);
     QCOMPARE(it.docId(), static_cast<quint64>(0));
 
@@ -89,7 +89,7 @@ void PhraseAndIteratorTest::testNullIterators()
     VectorPositionInfoIterator* it1 = new VectorPositionInfoIterator(vec1);
     VectorPositionInfoIterator* it2 = new VectorPositionInfoIterator(vec2);
 
-    QVector<VectorPositionInfoIterator*> vec = {it1, nullptr, it2};
+    QVector<PositionInfoIterator*> vec = {it1, nullptr, it2};
     PhraseAndIterator it(vec);
     QCOMPARE(it.docId(), static_cast<quint64>(0));
     QCOMPARE(it.next(), static_cast<quint64>(0));
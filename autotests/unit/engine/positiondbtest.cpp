@@ -8,7 +8,7 @@
 #include "positiondb.h"
 #include "dbtest.h"
 #include "positioninfo.h"
-#include "vectorpositioninfoiterator.h"
+#include "positioninfoiterator.h"
 
 using namespace Baloo;
 
@@ -51,7 +51,7 @@ private Q_SLOTS:
 
         db.put(word, list);
 
-        std::unique_ptr<VectorPositionInfoIterator> it{db.iter(word)};
+        std::unique_ptr<PositionInfoIterator> it{db.iter(word)};
         QCOMPARE(it->docId(), static_cast<quint64>(0));
         QVERIFY(it->positions().isEmpty());
 
@@ -67,6 +67,67 @@ private Q_SLOTS:
         QCOMPARE(it->docId(), static_cast<quint64>(0));
         QVERIFY(it->positions().isEmpty());
     }
+
+    void testChunks() {
+        PositionDB db(PositionDB::create(m_txn), m_txn);
+
+        QVector<PositionInfo> list;
+        for (quint64 id = 1; id <= 2500; id++) {
+            list << PositionInfo(id, {static_cast<uint>(id % 100), 200});
+        }
+        db.put("fire", list);
+
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 1025, 2049}));
+        QCOMPARE(db.get("fire"), list);
+        QCOMPARE(db.toTestMap().value("fire"), list);
+
+        std::unique_ptr<PositionInfoIterator> it{db.iter("fire")};
+        QVERIFY(it);
+        for (const PositionInfo& info : std::as_const(list)) {
+            QCOMPARE(it->next(), info.docId);
+            QCOMPARE(it->positions(), info.positions);
+        }
+        QCOMPARE(it->next(), static_cast<quint64>(0));
+
+        // The emptied chunk takes over the following one
+        db.putChunk("fire", 1025, {});
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 1025}));
+        QCOMPARE(db.getChunk("fire", 1025).first().docId, static_cast<quint64>(2049));
+        QCOMPARE(db.get("fire").size(), 2500 - 1024);
+
+        // Growing a chunk beyond the limit splits it in half
+        QVector<PositionInfo> chunk = db.getChunk("fire", 1025);
+        for (quint64 id = 2501; id <= 3500; id++) {
+            chunk << PositionInfo(id, {1});
+        }
+        db.putChunk("fire", 1025, chunk);
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 1025, 2775}));
+        QCOMPARE(db.getChunk("fire", 1025).size(), 726);
+        QCOMPARE(db.get("fire").size(), 2500 - 1024 + 1000);
+    }
+
+    void testPositions() {
+        PositionDB db(PositionDB::create(m_txn), m_txn);
+
+        QVector<PositionInfo> list;
+        for (quint64 id = 2; id <= 5000; id += 2) {
+            list << PositionInfo(id, {static_cast<uint>(id % 100), 200});
+        }
+        db.put("fire", list);
+        db.put("firea", {PositionInfo(1, {7})});
+
+        QCOMPARE(db.positions("fire", 2), (QVector<uint>{2, 200}));
+        QCOMPARE(db.positions("fire", 2050), (QVector<uint>{50, 200}));
+        QCOMPARE(db.positions("fire", 2052), (QVector<uint>{52, 200}));
+        QCOMPARE(db.positions("fire", 5000), (QVector<uint>{0, 200}));
+        QVERIFY(db.positions("fire", 1).isEmpty());
+        QVERIFY(db.positions("fire", 2051).isEmpty());
+        QVERIFY(db.positions("fire", 6000).isEmpty());
+
+        QCOMPARE(db.positions("firea", 1), QVector<uint>{7});
+        QVERIFY(db.positions("fir", 1).isEmpty());
+        QVERIFY(db.positions("water", 2).isEmpty());
+    }
 };
 
 QTEST_MAIN(PositionDBTest)
@@ -42,6 +42,32 @@ private Q_SLOTS:
         }
     }
 
+    void testTermIterSkipTo() {
+        PostingDB db(PostingDB::create(m_txn), m_txn);
+
+        PostingList list;
+        for (quint64 id = 2; id < 20000; id += 2) {
+            list << id;
+        }
+        db.put("even", list);
+
+        std::unique_ptr<PostingIterator> it{db.iter("even")};
+        QVERIFY(it);
+
+        QCOMPARE(it->skipTo(7), static_cast<quint64>(8));
+        QCOMPARE(it->next(), static_cast<quint64>(10));
+        QCOMPARE(it->skipTo(10), static_cast<quint64>(10));
+        QCOMPARE(it->skipTo(5001), static_cast<quint64>(5002));
+        QCOMPARE(it->docId(), static_cast<quint64>(5002));
+        QCOMPARE(it->skipTo(19998), static_cast<quint64>(19998));
+        QCOMPARE(it->next(), static_cast<quint64>(0));
+        QCOMPARE(it->skipTo(20000), static_cast<quint64>(0));
+
+        it.reset(db.iter("even"));
+        QCOMPARE(it->skipTo(20000), static_cast<quint64>(0));
+        QCOMPARE(it->docId(), static_cast<quint64>(0));
+    }
+
     void testPrefixIter() {
         PostingDB db(PostingDB::create(m_txn), m_txn);
 
@@ -60,6 +86,35 @@ private Q_SLOTS:
         }
     }
 
+    void testPrefixIterMixedSizes() {
+        PostingDB db(PostingDB::create(m_txn), m_txn);
+
+        PostingList large1;
+        PostingList large2;
+        for (quint64 id = 1; id < 1000; id++) {
+            large1 << 3 * id;
+            large2 << 5 * id;
+        }
+        db.put("fire", large1);
+        db.put("fired", {1, 2, 3});
+        db.put("fireman", large2);
+        db.put("fires", {2, 7, 10000});
+        db.put("fort", {4});
+
+        std::unique_ptr<PostingIterator> it{db.prefixIter("fire")};
+        QVERIFY(it);
+
+        PostingList expected = large1 + large2 + PostingList{1, 2, 3, 7, 10000};
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        PostingList result;
+        while (it->next()) {
+            result << it->docId();
+        }
+        QCOMPARE(result, expected);
+    }
+
     void testRegExpIter() {
         PostingDB db(PostingDB::create(m_txn), m_txn);
 
@@ -149,6 +204,91 @@ private Q_SLOTS:
         QVector<QByteArray> list = {"fir", "fire", "fore"};
         QCOMPARE(db.fetchTermsStartingWith("f"), list);
     }
+
+    void testChunks() {
+        PostingDB db(PostingDB::create(m_txn), m_txn);
+
+        PostingList list;
+        for (quint64 id = 1; id <= 10000; id++) {
+            list << id;
+        }
+        db.put("fire", list);
+        db.put("fired", {5, 20000});
+
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 4097, 8193}));
+        QCOMPARE(db.get("fire"), list);
+        QCOMPARE(db.getChunk("fire", 4097), list.mid(4096, 4096));
+        QCOMPARE(db.fetchTermsStartingWith("fire"), (QVector<QByteArray>{"fire", "fired"}));
+        QCOMPARE(db.toTestMap().value("fire"), list);
+
+        std::unique_ptr<PostingIterator> it{db.iter("fire")};
+        QVERIFY(it);
+        QCOMPARE(it->estimatedSize(), static_cast<quint64>(10000));
+        QCOMPARE(it->next(), static_cast<quint64>(1));
+        QCOMPARE(it->skipTo(4096), static_cast<quint64>(4096));
+        QCOMPARE(it->next(), static_cast<quint64>(4097));
+        QCOMPARE(it->skipTo(9000), static_cast<quint64>(9000));
+        QCOMPARE(it->skipTo(10001), static_cast<quint64>(0));
+
+        it.reset(db.prefixIter("fire"));
+        QVERIFY(it);
+        QCOMPARE(it->skipTo(9999), static_cast<quint64>(9999));
+        QCOMPARE(it->next(), static_cast<quint64>(10000));
+        QCOMPARE(it->next(), static_cast<quint64>(20000));
+        QCOMPARE(it->next(), static_cast<quint64>(0));
+
+        // Growing a chunk beyond the limit splits it in half
+        PostingList chunk;
+        for (quint64 id = 8193; id < 8193 + 4100; id++) {
+            chunk << id;
+        }
+        db.putChunk("fire", 8193, chunk);
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 4097, 8193, 10243}));
+        QCOMPARE(db.getChunk("fire", 8193), chunk.mid(0, 2050));
+        QCOMPARE(db.getChunk("fire", 10243), chunk.mid(2050));
+
+        // Removing the first chunk moves the next one in its place
+        db.putChunk("fire", 0, {});
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, 8193, 10243}));
+        QCOMPARE(db.get("fire").first(), static_cast<quint64>(4097));
+        QCOMPARE(db.get("fire").size(), 4096 + 4100);
+
+        db.del("fire");
+        QVERIFY(db.chunks("fire").isEmpty());
+        QCOMPARE(db.get("fired"), (PostingList{5, 20000}));
+    }
+
+    void testChunkBalance() {
+        PostingDB db(PostingDB::create(m_txn), m_txn);
+
+        // A full chunk of ids spread over the id range
+        PostingList list;
+        for (quint64 id = 2; id <= 2 * PostingDB::ChunkSize; id += 2) {
+            list << id;
+        }
+        db.put("fire", list);
+        db.put("fired", {1});
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0}));
+
+        // An insert at the start leaves two half full chunks, not a full one
+        // and a single id
+        PostingList inserted = list;
+        inserted.prepend(1);
+        db.putChunk("fire", 0, inserted);
+        const quint64 second = inserted[inserted.size() / 2];
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0, second}));
+        QCOMPARE(db.getChunk("fire", 0).size(), inserted.size() / 2);
+
+        // An undersized chunk takes over the following chunk
+        db.putChunk("fire", 0, {1, 2});
+        QCOMPARE(db.chunks("fire"), (QVector<quint64>{0}));
+        QCOMPARE(db.get("fire"), (PostingList{1, 2} + inserted.mid(inserted.size() / 2)));
+
+        // The last chunk has no following chunk to merge with
+        db.putChunk("fire", 0, {3});
+        QCOMPARE(db.get("fire"), (PostingList{3}));
+        QCOMPARE(db.get("fired"), (PostingList{1}));
+    }
 };
 
 QTEST_MAIN(PostingDBTest)
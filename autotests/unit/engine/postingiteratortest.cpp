@@ -19,6 +19,7 @@ class PostingIteratorTest : public QObject
 private Q_SLOTS:
     void test();
     void test2();
+    void testVectorSkipTo();
 };
 
 void PostingIteratorTest::test()
@@ -71,6 +72,26 @@ void PostingIteratorTest::test2()
     QCOMPARE(it.docId(), static_cast<quint64>(0));
 }
 
+void PostingIteratorTest::testVectorSkipTo()
+{
+    QVector<quint64> list;
+    for (quint64 id = 3; id < 3000; id += 3) {
+        list << id;
+    }
+
+    VectorPostingIterator it(list);
+    QCOMPARE(it.skipTo(1), static_cast<quint64>(3));
+    QCOMPARE(it.skipTo(3), static_cast<quint64>(3));
+    QCOMPARE(it.skipTo(4), static_cast<quint64>(6));
+    QCOMPARE(it.next(), static_cast<quint64>(9));
+    QCOMPARE(it.skipTo(1000), static_cast<quint64>(1002));
+    QCOMPARE(it.docId(), static_cast<quint64>(1002));
+    QCOMPARE(it.skipTo(2997), static_cast<quint64>(2997));
+    QCOMPARE(it.skipTo(2998), static_cast<quint64>(0));
+    QCOMPARE(it.docId(), static_cast<quint64>(0));
+    QCOMPARE(it.next(), static_cast<quint64>(0));
+}
+
 QTEST_MAIN(PostingIteratorTest)
 
 #include "postingiteratortest.moc"
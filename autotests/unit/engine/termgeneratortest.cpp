@@ -8,10 +8,63 @@
 #include "termgenerator.h"
 #include "document.h"
 
+#include <QRandomGenerator>
 #include <QTest>
+#include <QTextBoundaryFinder>
 
 using namespace Baloo;
 
+namespace {
+// The term splitting before the ASCII fast path was added, as reference
+QByteArrayList referenceTermList(const QString& text_)
+{
+    QString text(text_);
+    text.replace(QLatin1Char('_'), QLatin1Char(' '));
+
+    auto normalizeTerm = [](const QString& str) {
+        const QString denormalized = str.normalized(QString::NormalizationForm_KD).toLower();
+        QString cleanString;
+        for (const auto& c : denormalized) {
+            if (!c.isMark()) {
+                cleanString.append(c);
+            }
+        }
+        return cleanString.normalized(QString::NormalizationForm_KC);
+    };
+
+    auto isSkipChar = [] (const QChar& c) {
+        return c.isPunct() || c.isMark() || c.isSpace() || (!c.isPrint() && !c.isSurrogate());
+    };
+
+    int start = 0;
+    QByteArrayList list;
+    QTextBoundaryFinder bf(QTextBoundaryFinder::Word, text);
+    for (; bf.position() != -1; bf.toNextBoundary()) {
+        int end = bf.position();
+        while (start < end && isSkipChar(text[start])) {
+            start++;
+        }
+        if (end == start) {
+            continue;
+        }
+
+        bool commit = bf.boundaryReasons() & (QTextBoundaryFinder::EndOfItem | QTextBoundaryFinder::StartOfItem);
+        if (!commit & (end == text.size() || isSkipChar(text[end]))) {
+            commit = true;
+        }
+
+        if (commit) {
+            const QString term = normalizeTerm(text.mid(start, end - start));
+            if (!term.isEmpty()) {
+                list << QStringView(term).left(TermGenerator::maxTermSize).toUtf8();
+            }
+            start = end;
+        }
+    }
+    return list;
+}
+}
+
 #include <QObject>
 
 class Baloo::TermGeneratorTest : public QObject
@@ -36,6 +89,11 @@ private Q_SLOTS:
     void testFilePaths_data();
     void testApostroph();
     void testApostroph_data();
+    void testAsciiFastPath();
+    void testAsciiFastPath_data();
+    void testAsciiFastPathRandom();
+    void testPositionLimit();
+    void testTermLimit();
 
     QList<QByteArray> allWords(const QString& str)
     {
@@ -169,13 +227,13 @@ void TermGeneratorTest::testWordPositions()
     expectedWords << QByteArray("hello") << QByteArray("hi") << QByteArray("how");
     QCOMPARE(words, expectedWords);
 
-    QVector<uint> posInfo1 = doc.m_terms.value("hello").positions;
+    QVector<uint> posInfo1 = doc.m_terms.positions("hello");
     QCOMPARE(posInfo1, QVector<uint>() << 1);
 
-    QVector<uint> posInfo2 = doc.m_terms.value("hi").positions;
+    QVector<uint> posInfo2 = doc.m_terms.positions("hi");
     QCOMPARE(posInfo2, QVector<uint>() << 2 << 4);
 
-    QVector<uint> posInfo3 = doc.m_terms.value("how").positions;
+    QVector<uint> posInfo3 = doc.m_terms.positions("how");
     QCOMPARE(posInfo3, QVector<uint>() << 3);
 }
 
@@ -194,10 +252,10 @@ void TermGeneratorTest::testWordPositionsCJK()
     expectedWords << QByteArray("你好你好") << QByteArray("我认识你");
     QCOMPARE(words, expectedWords);
 
-    QVector<uint> posInfo1 = doc.m_terms.value("你好你好").positions;
+    QVector<uint> posInfo1 = doc.m_terms.positions("你好你好");
     QCOMPARE(posInfo1, QVector<uint>() << 1);
 
-    QVector<uint> posInfo2 = doc.m_terms.value("我认识你").positions;
+    QVector<uint> posInfo2 = doc.m_terms.positions("我认识你");
     QCOMPARE(posInfo2, QVector<uint>() << 2);
 }
 
@@ -271,6 +329,95 @@ void TermGeneratorTest::testApostroph_data()
         << QList<QByteArray>({"one", "two"});
 }
 
+void TermGeneratorTest::testAsciiFastPath()
+{
+    QFETCH(QString, input);
+
+    QCOMPARE(TermGenerator::termList(input), referenceTermList(input));
+}
+
+void TermGeneratorTest::testAsciiFastPath_data()
+{
+    QTest::addColumn<QString>("input");
+
+    QTest::addRow("sentence") << QStringLiteral("The quick (\"brown\") 'fox' can't jump 32.3 feet, right? No-Wrong;xx.txt");
+    QTest::addRow("numbers") << QStringLiteral("1,000 1;2 1.2.3 a1.2 1a.b 1.a a.1 10:30 1'2 3.14.");
+    QTest::addRow("apostrophes") << QStringLiteral("don't 'quoted' a'b'c a''b a'1");
+    QTest::addRow("colon") << QStringLiteral("std::vector a:b http://kde.org");
+    QTest::addRow("symbols") << QStringLiteral("a+b $100 x<=y ~/foo a|b `cmd` x^2 +-+ a=b");
+    QTest::addRow("code") << QStringLiteral("if (x->size() >= 10 && y_z != 0) { return foo_bar[i]; } // TODO");
+    QTest::addRow("control") << QStringLiteral("word1\u0001word2\tword3\r\nword4\u007fword5");
+    QTest::addRow("long") << QStringLiteral("averyveryveryverylongwordthatistruncated short");
+    QTest::addRow("lines") << QStringLiteral("first line\nsecond_line\r\n\n\nlast");
+    QTest::addRow("mixed lines") << QString::fromUtf8("plain ascii\nCómo está Kûg\nmore ascii.txt\n你好世界 hello\nend");
+    QTest::addRow("mark after line feed") << QString::fromUtf8("abc\n\u0301def\nghi");
+}
+
+void TermGeneratorTest::testAsciiFastPathRandom()
+{
+    // Random ASCII, with some letters and digits more to form words
+    const QByteArray alphabet = QByteArrayLiteral("abcXYZ019abcxyz019 .,;:'\"_-+=$<>^`|~/\\()[]{}!?@#%&*\t\r\n\x01\x7f");
+    QRandomGenerator random(42);
+
+    for (int run = 0; run < 2000; ++run) {
+        QString input;
+        const int size = random.bounded(1, 60);
+        for (int i = 0; i < size; ++i) {
+            input += QLatin1Char(alphabet[random.bounded(int(alphabet.size()))]);
+        }
+
+        const QByteArrayList terms = TermGenerator::termList(input);
+        const QByteArrayList expected = referenceTermList(input);
+        if (terms != expected) {
+            qDebug() << input;
+        }
+        QCOMPARE(terms, expected);
+    }
+}
+
+void TermGeneratorTest::testPositionLimit()
+{
+    Document doc;
+    TermGenerator termGen(doc);
+
+    QString str;
+    for (int i = 0; i < Document::maxTermPositions + 10; ++i) {
+        str += QStringLiteral("log line\n");
+    }
+    termGen.indexText(str);
+
+    QCOMPARE(doc.m_terms.keys(), QList<QByteArray>({"line", "log"}));
+    const QVector<uint> positions = doc.m_terms.positions("log");
+    QCOMPARE(positions.size(), Document::maxTermPositions);
+    QCOMPARE(positions.first(), 1u);
+    QCOMPARE(positions.last(), uint(2 * Document::maxTermPositions - 1));
+}
+
+void TermGeneratorTest::testTermLimit()
+{
+    Document doc;
+    TermGenerator termGen(doc);
+    termGen.setMaxTerms(1000);
+
+    // Like a log with a unique id on every line
+    for (int chunk = 0; chunk < 10; ++chunk) {
+        QString str;
+        for (int i = 0; i < 10000; ++i) {
+            str += QStringLiteral("log id%1\n").arg(chunk * 10000 + i);
+        }
+        termGen.indexText(str);
+        QVERIFY(doc.termCount() <= 1000);
+    }
+
+    QCOMPARE(doc.termCount(), 1000);
+    QCOMPARE(termGen.droppedTerms(), 100000 - 999);
+
+    // Known terms are still added
+    QVERIFY(doc.hasTerm("id998"));
+    QVERIFY(!doc.hasTerm("id999"));
+    QCOMPARE(doc.m_terms.positions("log").size(), Document::maxTermPositions);
+}
+
 QTEST_MAIN(TermGeneratorTest)
 
 #include "termgeneratortest.moc"
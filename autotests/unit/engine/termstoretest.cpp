@@ -0,0 +1,106 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "termstore.h"
+
+#include <QMap>
+#include <QTest>
+
+using namespace Baloo;
+
+class TermStoreTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSorted();
+    void testPositions();
+    void testAddAfterRead();
+    void testPositionLimit();
+    void testManyTerms();
+};
+
+void TermStoreTest::testSorted()
+{
+    TermStore terms;
+    terms.add("foo");
+    terms.add("bar");
+    terms.add("foobar");
+    terms.add("bar");
+
+    QCOMPARE(terms.size(), 3);
+    QCOMPARE(terms.keys(), QList<QByteArray>({"bar", "foo", "foobar"}));
+    QCOMPARE(terms.at(0).term().toByteArray(), QByteArray("bar"));
+    QCOMPARE(terms.at(0).positionCount(), 0);
+}
+
+void TermStoreTest::testPositions()
+{
+    TermStore terms;
+    terms.add("b", 1);
+    terms.add("a", 2);
+    terms.add("b", 3);
+    terms.add("a");
+    terms.add("b", 4);
+
+    QCOMPARE(terms.positions("a"), QVector<uint>({2}));
+    QCOMPARE(terms.positions("b"), QVector<uint>({1, 3, 4}));
+    QCOMPARE(terms.at(1).positions(), QVector<uint>({1, 3, 4}));
+    QVERIFY(terms.positions("c").isEmpty());
+}
+
+void TermStoreTest::testAddAfterRead()
+{
+    TermStore terms;
+    terms.add("b", 1);
+    terms.add("a", 2);
+    QCOMPARE(terms.keys(), QList<QByteArray>({"a", "b"}));
+
+    terms.add("b", 3);
+    terms.add("0", 4);
+    QCOMPARE(terms.keys(), QList<QByteArray>({"0", "a", "b"}));
+    QCOMPARE(terms.positions("a"), QVector<uint>({2}));
+    QCOMPARE(terms.positions("b"), QVector<uint>({1, 3}));
+
+    terms.clear();
+    QVERIFY(terms.isEmpty());
+    QVERIFY(terms.positions("b").isEmpty());
+}
+
+void TermStoreTest::testPositionLimit()
+{
+    TermStore terms;
+    for (int i = 0; i < TermStore::maxPositions + 5; ++i) {
+        terms.add("a", i);
+    }
+
+    const QVector<uint> positions = terms.positions("a");
+    QCOMPARE(positions.size(), TermStore::maxPositions);
+    QCOMPARE(positions.last(), uint(TermStore::maxPositions - 1));
+}
+
+void TermStoreTest::testManyTerms()
+{
+    TermStore terms;
+    QMap<QByteArray, QVector<uint>> expected;
+    for (uint i = 0; i < 10000; ++i) {
+        const QByteArray term = QByteArray::number(i % 3001);
+        terms.add(term, i);
+        expected[term].append(i);
+    }
+
+    QCOMPARE(terms.size(), expected.size());
+    int i = 0;
+    for (auto it = expected.cbegin(); it != expected.cend(); ++it, ++i) {
+        const TermStore::Entry entry = terms.at(i);
+        QCOMPARE(entry.term().toByteArray(), it.key());
+        QCOMPARE(entry.positions(), it.value());
+    }
+}
+
+QTEST_MAIN(TermStoreTest)
+
+#include "termstoretest.moc"
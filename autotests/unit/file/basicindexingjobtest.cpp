@@ -6,6 +6,7 @@
 
 #include "basicindexingjob.h"
 
+#include <cstring>
 #include <vector>
 #include <QByteArray>
 #include <QDateTime>
@@ -29,6 +30,7 @@ private Q_SLOTS:
     void testBasicIndexing();
     void testBasicIndexingTypes_data();
     void testBasicIndexingTypes();
+    void testContentIndexingPriority();
 
 private:
     struct TestFile {
@@ -155,6 +157,29 @@ void BasicIndexingJobTest::testBasicIndexingTypes()
     }
 }
 
+void BasicIndexingJobTest::testContentIndexingPriority()
+{
+    constexpr quint32 day = 24 * 60 * 60;
+
+    QT_STATBUF statBuf;
+    memset(&statBuf, 0, sizeof(statBuf));
+    statBuf.st_mtime = 100 * day;
+    statBuf.st_size = 1000;
+    const quint32 small = BasicIndexingJob::contentIndexingPriority("/home/a", statBuf);
+    QCOMPARE(small, Document::defaultContentIndexingPriority(100 * day));
+
+    // Newer files come first
+    statBuf.st_mtime = 101 * day;
+    QCOMPARE(BasicIndexingJob::contentIndexingPriority("/home/a", statBuf), small - day);
+
+    // Large files and hidden folders are treated as older
+    statBuf.st_mtime = 100 * day;
+    statBuf.st_size = 20 * 1024 * 1024;
+    QCOMPARE(BasicIndexingJob::contentIndexingPriority("/home/a", statBuf), small + 2 * day);
+    statBuf.st_size = 1000;
+    QCOMPARE(BasicIndexingJob::contentIndexingPriority("/home/.cache/a", statBuf), small + 30 * day);
+}
+
 QTEST_GUILESS_MAIN(BasicIndexingJobTest)
 
 #include "basicindexingjobtest.moc"
@@ -0,0 +1,91 @@
+/*
+    This file is part of the KDE Baloo Project
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "batchsizecontroller.h"
+
+#include <QTest>
+
+using namespace Baloo;
+
+class BatchSizeControllerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testInitialSize();
+    void testFastFiles();
+    void testSlowFiles();
+    void testSlowCommit();
+    void testMemoryUsage();
+    void testEmptyBatch();
+};
+
+void BatchSizeControllerTest::testInitialSize()
+{
+    QCOMPARE(BatchSizeController(40).batchSize(), 40u);
+    QCOMPARE(BatchSizeController(0).batchSize(), BatchSizeController::MinBatchSize);
+    QCOMPARE(BatchSizeController(100000).batchSize(), BatchSizeController::MaxBatchSize);
+}
+
+void BatchSizeControllerTest::testFastFiles()
+{
+    BatchSizeController controller(40);
+
+    // 1 msec per file, grows at most by a factor of two per batch
+    controller.handleBatch(40, 40, 5, 0);
+    QCOMPARE(controller.batchSize(), 80u);
+
+    for (int i = 0; i < 10; i++) {
+        const uint size = controller.batchSize();
+        controller.handleBatch(size, size, 5, 0);
+    }
+    QCOMPARE(controller.batchSize(), BatchSizeController::MaxBatchSize);
+}
+
+void BatchSizeControllerTest::testSlowFiles()
+{
+    BatchSizeController controller(40);
+
+    // 1 sec per file, the batch should take about TargetTime
+    for (int i = 0; i < 10; i++) {
+        const uint size = controller.batchSize();
+        controller.handleBatch(size, size * 1000, 5, 0);
+    }
+    QCOMPARE(controller.batchSize(), BatchSizeController::TargetTime / 1000);
+}
+
+void BatchSizeControllerTest::testSlowCommit()
+{
+    BatchSizeController controller(100);
+
+    // Fast extraction, but committing 100 files takes a second
+    controller.handleBatch(100, 1000, 1000, 0);
+    QCOMPARE(controller.batchSize(), 100 * BatchSizeController::TargetCommitTime / 1000);
+}
+
+void BatchSizeControllerTest::testMemoryUsage()
+{
+    BatchSizeController controller(100);
+
+    controller.handleBatch(100, 100, 5, 2 * BatchSizeController::MemoryGrowthLimit);
+    QCOMPARE(controller.batchSize(), 50u);
+
+    // A large extractor which does not grow any more keeps the size
+    controller.handleBatch(50, 50, 5, 0);
+    QCOMPARE(controller.batchSize(), 100u);
+}
+
+void BatchSizeControllerTest::testEmptyBatch()
+{
+    BatchSizeController controller(40);
+
+    controller.handleBatch(0, 1000, 0, 0);
+    QCOMPARE(controller.batchSize(), 40u);
+}
+
+QTEST_GUILESS_MAIN(BatchSizeControllerTest)
+
+#include "batchsizecontrollertest.moc"
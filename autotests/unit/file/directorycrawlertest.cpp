@@ -0,0 +1,310 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "fileindexerconfigutils.h"
+#include "directorycrawler.h"
+#include "filtereddiriterator.h"
+#include "fileindexerconfig.h"
+#include "idutils.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace {
+    const QStringList dataSet() {
+        static QStringList dataSet = {
+            QStringLiteral("home/"),
+            QStringLiteral("home/1"),
+            QStringLiteral("home/2"),
+            QStringLiteral("home/kde/"),
+            QStringLiteral("home/kde/1"),
+            QStringLiteral("home/docs/"),
+            QStringLiteral("home/docs/1"),
+            QStringLiteral("home/docs/a/"),
+            QStringLiteral("home/docs/a/b/"),
+            QStringLiteral("home/docs/a/b/c/"),
+            QStringLiteral("home/docs/a/b/c/1"),
+            QStringLiteral("home/docs/a/b/c/2"),
+            QStringLiteral("home/docs/.fire"),
+            QStringLiteral("home/.hiddenDir/"),
+            QStringLiteral("home/.hiddenFile"),
+            QStringLiteral("home/.includedHidden/"),
+            QStringLiteral("home/.includedHidden/dir/"),
+            QStringLiteral("home/.includedHidden/file"),
+            QStringLiteral("home/.includedHidden/.hidden"),
+        };
+        return dataSet;
+    }
+}
+
+using namespace Baloo;
+
+namespace {
+    using Fingerprints = QHash<quint64, FolderFingerprintDB::Fingerprint>;
+
+    DirectoryCrawler::WorkerFactory urlFactory(bool filesOnly = false, const Fingerprints* fingerprints = nullptr)
+    {
+        return [filesOnly, fingerprints] {
+            DirectoryCrawler::Worker worker;
+            worker.process = [filesOnly](FilteredDirIterator& it, DirectoryCrawler::Item& item) {
+                if (filesOnly && it.isDir()) {
+                    return false;
+                }
+                item.document.setId(statBufToId(it.statBuf()));
+                item.document.setUrl(QFile::encodeName(it.filePath()));
+                // Marks the files returned without a stat
+                item.document.setContentIndexing(!it.hasStat());
+                return true;
+            };
+            if (fingerprints) {
+                worker.unchanged = [fingerprints](const QT_STATBUF& folderStat, FolderFingerprintDB::Fingerprint& fingerprint) {
+                    const auto it = fingerprints->constFind(statBufToId(folderStat));
+                    if (it == fingerprints->constEnd()) {
+                        return false;
+                    }
+                    fingerprint = it.value();
+                    return fingerprint.mTime == quint32(folderStat.st_mtime) && fingerprint.cTime == quint32(folderStat.st_ctime);
+                };
+            }
+            return worker;
+        };
+    }
+
+    // Returns the urls of the crawled entries relative to \p dir, and the
+    // urls of the entries returned without a stat in \p unstated
+    QSet<QString> crawl(DirectoryCrawler& crawler, const QString& dir, Fingerprints& fingerprints,
+                        QSet<QString>* unstated = nullptr)
+    {
+        QSet<QString> list;
+        DirectoryCrawler::Item item;
+        while (crawler.next(item)) {
+            if (item.folderId) {
+                fingerprints.insert(item.folderId, item.fingerprint);
+                continue;
+            }
+            const QString path = QFile::decodeName(item.document.url()).mid(dir.length());
+            list << path;
+            if (unstated && item.document.contentIndexing()) {
+                *unstated << path;
+            }
+        }
+        return list;
+    }
+}
+
+class DirectoryCrawlerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCrawl_data();
+    void testCrawl();
+    void testSkippedEntries();
+    void testStop();
+    void testMissingFolder();
+    void testFingerprints();
+    void testParentsFirst_data();
+    void testParentsFirst();
+};
+
+void DirectoryCrawlerTest::testCrawl_data()
+{
+    QTest::addColumn<uint>("threadCount");
+
+    QTest::newRow("1 thread") << 1u;
+    QTest::newRow("2 threads") << 2u;
+    QTest::newRow("8 threads") << 8u;
+}
+
+void DirectoryCrawlerTest::testCrawl()
+{
+    QFETCH(uint, threadCount);
+
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+
+    QStringList includeFolders = {
+        dir->path() + QLatin1String("/home"),
+        dir->path() + QLatin1String("/home/.includedHidden"),
+    };
+
+    QStringList excludeFolders = {
+        dir->path() + QLatin1String("/home/kde")
+    };
+
+    Test::writeIndexerConfig(includeFolders, excludeFolders);
+
+    FileIndexerConfig config;
+
+    // The crawl returns the entries of the recursive iterator
+    QMap<QString, quint64> expected;
+    FilteredDirIterator it(&config, includeFolders.first());
+    while (!it.next().isEmpty()) {
+        expected.insert(it.filePath(), statBufToId(it.statBuf()));
+    }
+    QCOMPARE(expected.size(), 13);
+
+    QMap<QString, quint64> list;
+    DirectoryCrawler crawler(&config, includeFolders.first(), threadCount, urlFactory());
+    DirectoryCrawler::Item item;
+    while (crawler.next(item)) {
+        if (item.folderId) {
+            continue;
+        }
+        const QString path = QFile::decodeName(item.document.url());
+        QVERIFY(!list.contains(path));
+        list.insert(path, item.document.id());
+    }
+    QCOMPARE(list, expected);
+
+    // Done stays done
+    QVERIFY(!crawler.next(item));
+}
+
+void DirectoryCrawlerTest::testSkippedEntries()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+
+    DirectoryCrawler crawler(nullptr, dir->path() + QLatin1String("/home"), 4, urlFactory(true));
+
+    QSet<QString> expected = {
+        QStringLiteral("/home/1"),
+        QStringLiteral("/home/2"),
+        QStringLiteral("/home/kde/1"),
+        QStringLiteral("/home/docs/1"),
+        QStringLiteral("/home/docs/a/b/c/1"),
+        QStringLiteral("/home/docs/a/b/c/2"),
+    };
+
+    Fingerprints fingerprints;
+    QCOMPARE(crawl(crawler, dir->path(), fingerprints), expected);
+}
+
+void DirectoryCrawlerTest::testStop()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+
+    // Destroying the crawler before the end stops the workers
+    for (uint threadCount : {1u, 4u}) {
+        DirectoryCrawler crawler(nullptr, dir->path() + QLatin1String("/home"), threadCount, urlFactory());
+        DirectoryCrawler::Item item;
+        QVERIFY(crawler.next(item));
+    }
+}
+
+void DirectoryCrawlerTest::testMissingFolder()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+
+    DirectoryCrawler crawler(nullptr, dir->path() + QLatin1String("/missing"), 2, urlFactory());
+    DirectoryCrawler::Item item;
+    QVERIFY(!crawler.next(item));
+}
+
+void DirectoryCrawlerTest::testFingerprints()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+    const QString home = dir->path() + QLatin1String("/home");
+
+    // Folders changed in the second of the listing get no fingerprint
+    QTest::qSleep(1100);
+
+    Fingerprints fingerprints;
+    QSet<QString> expected;
+    {
+        DirectoryCrawler crawler(nullptr, home, 4, urlFactory());
+        expected = crawl(crawler, dir->path(), fingerprints);
+    }
+    QCOMPARE(expected.size(), 12);
+
+    // All listed folders, the entry count includes the filtered entries
+    QCOMPARE(fingerprints.size(), 6);
+    QT_STATBUF statBuf;
+    QCOMPARE(filePathToStat(QFile::encodeName(home), statBuf), 0);
+    QVERIFY(fingerprints.contains(statBufToId(statBuf)));
+    QCOMPARE(fingerprints.value(statBufToId(statBuf)).entryCount, 7u);
+
+    // The files of the unchanged folders are returned without a stat. The
+    // root folder is always listed with the stats
+    const QSet<QString> rootFiles = {
+        QStringLiteral("/home/1"),
+        QStringLiteral("/home/2"),
+    };
+    {
+        Fingerprints unchanged;
+        QSet<QString> unstated;
+        DirectoryCrawler crawler(nullptr, home, 4, urlFactory(false, &fingerprints));
+        QCOMPARE(crawl(crawler, dir->path(), unchanged, &unstated), expected);
+        QCOMPARE(unstated.size(), 4);
+        QVERIFY(!unstated.intersects(rootFiles));
+        QVERIFY(unchanged.isEmpty());
+    }
+
+    // A wrong entry count lists the folder again with the stats
+    QCOMPARE(filePathToStat(QFile::encodeName(home + QLatin1String("/docs/a/b/c")), statBuf), 0);
+    fingerprints[statBufToId(statBuf)].entryCount++;
+    {
+        Fingerprints relisted;
+        QSet<QString> unstated;
+        DirectoryCrawler crawler(nullptr, home, 4, urlFactory(false, &fingerprints));
+        QCOMPARE(crawl(crawler, dir->path(), relisted, &unstated), expected);
+        QCOMPARE(unstated, QSet<QString>({QStringLiteral("/home/kde/1"), QStringLiteral("/home/docs/1")}));
+        QCOMPARE(relisted.size(), 1);
+        QVERIFY(relisted.contains(statBufToId(statBuf)));
+    }
+}
+
+void DirectoryCrawlerTest::testParentsFirst_data()
+{
+    QTest::addColumn<uint>("threadCount");
+
+    QTest::newRow("1 thread") << 1u;
+    QTest::newRow("2 threads") << 2u;
+    QTest::newRow("8 threads") << 8u;
+}
+
+void DirectoryCrawlerTest::testParentsFirst()
+{
+    QFETCH(uint, threadCount);
+
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+    const QString home = dir->path() + QLatin1String("/home");
+
+    // Folders changed in the second of the listing get no fingerprint
+    QTest::qSleep(1100);
+
+    // The consumers look up the parent of each item, so it has to be
+    // returned before any of its children. Checked for the full listing
+    // and for the quick listing of unchanged folders.
+    Fingerprints fingerprints;
+    for (int run = 0; run < 20; run++) {
+        const bool quick = run % 2;
+        Fingerprints stored;
+        QSet<QString> returned;
+        DirectoryCrawler crawler(nullptr, home, threadCount, urlFactory(false, quick ? &fingerprints : nullptr));
+        DirectoryCrawler::Item item;
+        while (crawler.next(item)) {
+            if (item.folderId) {
+                stored.insert(item.folderId, item.fingerprint);
+                continue;
+            }
+            const QString path = QFile::decodeName(item.document.url());
+            if (path != home) {
+                const QString parent = path.left(path.lastIndexOf(QLatin1Char('/')));
+                QVERIFY2(returned.contains(parent), qPrintable(path));
+            }
+            returned << path;
+        }
+        QCOMPARE(returned.size(), 12);
+        if (!quick) {
+            fingerprints = stored;
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(DirectoryCrawlerTest)
+
+#include "directorycrawlertest.moc"
@@ -42,6 +42,17 @@ int main(int argc, char* argv[])
                 qCInfo(BALOO) << "Processing ...";
                 for(auto id : ids) {
                     worker.urlStarted(QString::number(id));
+
+                    Baloo::ExtractedFile file;
+                    file.id = id;
+                    file.action = Baloo::ExtractedFile::ReplaceDocument;
+                    file.document.setId(id);
+                    file.document.setUrl(QByteArray::number(id));
+                    file.document.addPositionTerm("term", 1);
+                    file.document.addPositionTerm("term", 3);
+                    file.document.addFileNamePositionTerm(QByteArray::number(id), 1);
+                    worker.fileExtracted(file);
+
                     worker.urlFinished(QString::number(id));
                 }
                 worker.batchFinished();
@@ -37,6 +37,7 @@ private Q_SLOTS:
     void singleBatch_data();
     void multipleBatch();
     void multipleSequentialBatches();
+    void extractedFiles();
     void closePipe();
 
 private:
@@ -146,6 +147,45 @@ void ExtractorCommandPipeTest::multipleSequentialBatches()
     QCOMPARE(spy.count(), 3);
 }
 
+void ExtractorCommandPipeTest::extractedFiles()
+{
+    QVector<Baloo::ExtractedFile> files;
+    auto connection = connect(&m_controller, &Baloo::Private::ControllerPipe::fileExtracted,
+         [&files](const Baloo::ExtractedFile& file) {
+             files.append(file);
+    });
+
+    QSignalSpy spy(&m_controller, &Baloo::Private::ControllerPipe::batchFinished);
+
+    m_controller.processIds({5, 1000});
+    QVERIFY(spy.wait());
+    disconnect(connection);
+
+    QCOMPARE(files.size(), 2);
+    QCOMPARE(files[0].id, quint64(5));
+    QCOMPARE(files[1].id, quint64(1000));
+
+    const Baloo::ExtractedFile& file = files[1];
+    QCOMPARE(file.action, Baloo::ExtractedFile::ReplaceDocument);
+    QCOMPARE(file.document.id(), quint64(1000));
+    QCOMPARE(file.document.url(), QByteArray("1000"));
+
+    Baloo::Document expected;
+    expected.setId(1000);
+    expected.setUrl("1000");
+    expected.addPositionTerm("term", 1);
+    expected.addPositionTerm("term", 3);
+    expected.addFileNamePositionTerm("1000", 1);
+
+    auto serialize = [](const Baloo::Document& doc) {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << doc;
+        return data;
+    };
+    QCOMPARE(serialize(file.document), serialize(expected));
+}
+
 void ExtractorCommandPipeTest::closePipe()
 {
     qRegisterMetaType<QProcess::ExitStatus>();
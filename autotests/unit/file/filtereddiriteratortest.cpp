@@ -8,7 +8,9 @@
 #include "fileindexerconfigutils.h"
 #include "filtereddiriterator.h"
 #include "fileindexerconfig.h"
+#include "idutils.h"
 
+#include <QFile>
 #include <QTemporaryDir>
 #include <QTest>
 
@@ -43,6 +45,9 @@ private Q_SLOTS:
     void testFolders();
     void testAddingExcludedFolder();
     void testNoConfig();
+    void testStatBuf();
+    void testFileStatSkipped();
+    void testSymlinkedFolder();
 };
 
 using namespace Baloo;
@@ -216,6 +221,112 @@ void FilteredDirIteratorTest::testNoConfig()
     QCOMPARE(list, expected);
 }
 
+void FilteredDirIteratorTest::testStatBuf()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+    const QString home = dir->path() + QLatin1String("/home");
+    QVERIFY(QFile::link(home + QLatin1String("/1"), home + QLatin1String("/link")));
+    QVERIFY(QFile::link(home + QLatin1String("/docs"), home + QLatin1String("/dirLink")));
+
+    FilteredDirIterator it(nullptr, home);
+
+    int count = 0;
+    while (!it.next().isEmpty()) {
+        const QByteArray path = QFile::encodeName(it.filePath());
+        QVERIFY(!path.endsWith("link") && !path.endsWith("Link"));
+
+        QT_STATBUF statBuf;
+        QCOMPARE(filePathToStat(path, statBuf), 0);
+        QCOMPARE(statBufToId(it.statBuf()), statBufToId(statBuf));
+        QCOMPARE(it.statBuf().st_mtime, statBuf.st_mtime);
+        QCOMPARE(it.isDir(), S_ISDIR(statBuf.st_mode));
+
+        if (count == 0) {
+            QCOMPARE(it.parentId(), quint64(0));
+        } else {
+            QCOMPARE(it.parentId(), filePathToId(path.left(path.lastIndexOf('/'))));
+        }
+        count++;
+    }
+    QCOMPARE(count, 7);
+}
+
+void FilteredDirIteratorTest::testFileStatSkipped()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+    const QString home = dir->path() + QLatin1String("/home");
+
+    FilteredDirIterator it(nullptr, home, FilteredDirIterator::FilesAndDirs, FilteredDirIterator::ChildrenOnly);
+    it.setFileStatSkipped(true);
+
+    int count = 0;
+    int files = 0;
+    int statedFiles = 0;
+    while (!it.next().isEmpty()) {
+        const QByteArray path = QFile::encodeName(it.filePath());
+        QT_STATBUF statBuf;
+        QCOMPARE(filePathToStat(path, statBuf), 0);
+
+        // The folders always have a stat, the files only on filesystems
+        // whose entry inodes may differ from the stat
+        if (it.isDir()) {
+            QVERIFY(it.hasStat());
+        } else {
+            files++;
+            statedFiles += it.hasStat();
+        }
+        QCOMPARE(statBufToId(it.statBuf()), statBufToId(statBuf));
+
+        QVERIFY(it.stat());
+        QVERIFY(it.hasStat());
+        QCOMPARE(it.statBuf().st_mtime, statBuf.st_mtime);
+        count++;
+    }
+    QCOMPARE(count, 4);
+    QVERIFY(statedFiles == 0 || statedFiles == files);
+
+    // The hidden entries are counted as well
+    QCOMPARE(it.entryCount(), 7u);
+}
+
+void FilteredDirIteratorTest::testSymlinkedFolder()
+{
+    std::unique_ptr<QTemporaryDir> dir(Test::createTmpFilesAndFolders(dataSet()));
+    const QString link = dir->path() + QLatin1String("/link");
+    QVERIFY(QFile::link(dir->path() + QLatin1String("/home"), link));
+    QVERIFY(QFile::link(dir->path() + QLatin1String("/home/docs"), dir->path() + QLatin1String("/home/dirLink")));
+
+    Test::writeIndexerConfig({link}, {});
+    FileIndexerConfig config;
+
+    // An include folder which is a symlink is followed, the symlinks
+    // below it are not
+    FilteredDirIterator it(&config, link);
+
+    QSet<QString> expected = {
+        QStringLiteral("/link"),
+        QStringLiteral("/link/1"),
+        QStringLiteral("/link/2"),
+        QStringLiteral("/link/kde"),
+        QStringLiteral("/link/kde/1"),
+        QStringLiteral("/link/docs"),
+        QStringLiteral("/link/docs/1"),
+    };
+
+    QSet<QString> list;
+    while (!it.next().isEmpty()) {
+        const QString path = it.filePath().mid(dir->path().length());
+        list << path;
+
+        // The children refer to the id of the link, as the ids of the
+        // documents are taken from the paths elsewhere
+        if (path == QLatin1String("/link/1")) {
+            QCOMPARE(it.parentId(), filePathToId(QFile::encodeName(link)));
+        }
+    }
+    QCOMPARE(list, expected);
+}
+
 QTEST_GUILESS_MAIN(FilteredDirIteratorTest)
 
 #include "filtereddiriteratortest.moc"
@@ -40,6 +40,7 @@ private Q_SLOTS:
     void testMoveFileRenameParent();
     void testRenameMoveFileRenameParent();
     void testMoveFileMoveParent();
+    void testSuspended();
 
 private:
     quint64 insertDoc(const QString& url, quint64 parentId);
@@ -445,6 +446,49 @@ void MetadataMoverTest::testMoveFileMoveParent()
     }
 }
 
+void MetadataMoverTest::testSuspended()
+{
+    QTemporaryDir dir;
+    auto did = filePathToId(QFile::encodeName(dir.path()));
+
+    const QString fileUrl = dir.path() + QStringLiteral("/file");
+    const quint64 fid = insertDoc(fileUrl, did);
+    const QString otherUrl = dir.path() + QStringLiteral("/other");
+    const quint64 oid = insertDoc(otherUrl, did);
+    const DocumentInfo oldInfo = documentInfo(fid);
+
+    MetadataMover mover(m_db.get(), this);
+    mover.setSuspended(true);
+
+    const QString fileUrl1 = dir.path() + QStringLiteral("/file1");
+    mover.moveFileMetadata(fileUrl, fileUrl1);
+    mover.removeFileMetadata(otherUrl);
+
+    // Nothing is written while suspended
+    {
+        Transaction tr(m_db.get(), Transaction::ReadOnly);
+        QCOMPARE(tr.documentUrl(fid), QFile::encodeName(fileUrl));
+        QVERIFY(tr.hasDocument(oid));
+    }
+
+    // The changes are applied in order on resume
+    mover.moveFileMetadata(fileUrl1, fileUrl);
+    mover.setSuspended(false);
+    {
+        Transaction tr(m_db.get(), Transaction::ReadOnly);
+        QCOMPARE(tr.documentUrl(fid), QFile::encodeName(fileUrl));
+        QCOMPARE(documentInfo(fid).filenameTerms, oldInfo.filenameTerms);
+        QVERIFY(!tr.hasDocument(oid));
+    }
+
+    // Resumed, the changes are written right away
+    mover.moveFileMetadata(fileUrl, fileUrl1);
+    {
+        Transaction tr(m_db.get(), Transaction::ReadOnly);
+        QCOMPARE(tr.documentUrl(fid), QFile::encodeName(fileUrl1));
+    }
+}
+
 QTEST_GUILESS_MAIN(MetadataMoverTest)
 
 #include "metadatamovertest.moc"
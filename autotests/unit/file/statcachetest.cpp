@@ -0,0 +1,76 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "statcache.h"
+#include "idutils.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Baloo;
+
+class StatCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testStat();
+    void testFolderId();
+    void testMissing();
+};
+
+void StatCacheTest::testStat()
+{
+    QTemporaryDir dir;
+    const QByteArray folder = QFile::encodeName(dir.path());
+    QFile file(dir.path() + QLatin1String("/file"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QVERIFY(QFile::link(file.fileName(), dir.path() + QLatin1String("/link")));
+
+    StatCache cache;
+    // The second stat of a path on the same device uses the cached filesystem id
+    const QList<QByteArray> paths = {folder, folder + "/file", folder + "/link", folder + "/file"};
+    for (const QByteArray& path : paths) {
+        QT_STATBUF expected;
+        QCOMPARE(filePathToStat(path, expected), 0);
+
+        QT_STATBUF statBuf;
+        QCOMPARE(cache.stat(path, statBuf), 0);
+        QCOMPARE(statBufToId(statBuf), statBufToId(expected));
+        QCOMPARE(statBuf.st_mode, expected.st_mode);
+        QCOMPARE(statBuf.st_mtime, expected.st_mtime);
+    }
+}
+
+void StatCacheTest::testFolderId()
+{
+    QTemporaryDir dir;
+    const QByteArray folder = QFile::encodeName(dir.path());
+    QVERIFY(QDir(dir.path()).mkdir(QStringLiteral("sub")));
+
+    StatCache cache;
+    QCOMPARE(cache.folderId(folder), filePathToId(folder));
+    QCOMPARE(cache.folderId(folder + "/sub"), filePathToId(folder + "/sub"));
+    QCOMPARE(cache.folderId(folder), filePathToId(folder));
+}
+
+void StatCacheTest::testMissing()
+{
+    QTemporaryDir dir;
+    const QByteArray path = QFile::encodeName(dir.path()) + "/missing";
+
+    StatCache cache;
+    QT_STATBUF statBuf;
+    QVERIFY(cache.stat(path, statBuf) != 0);
+    QCOMPARE(cache.folderId(path), quint64(0));
+}
+
+QTEST_GUILESS_MAIN(StatCacheTest)
+
+#include "statcachetest.moc"
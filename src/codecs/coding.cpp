@@ -89,6 +89,24 @@ char* getDifferentialVarInt32(char* p, char* limit, QVector<quint32>* values)
     return p;
 }
 
+const char* skipDifferentialVarInt32(const char* p, const char* limit)
+{
+    quint32 size = 0;
+    p = getVarint32Ptr(const_cast<char*>(p), const_cast<char*>(limit), &size);
+    if (!p) {
+        return nullptr;
+    }
+
+    // The last byte of each VarInt has the high bit cleared
+    while (size && p < limit) {
+        if (!(*(reinterpret_cast<const unsigned char*>(p)) & 128)) {
+            size--;
+        }
+        p++;
+    }
+    return size ? nullptr : p;
+}
+
 char* getVarint32PtrFallback(char* p, char* limit, quint32* value)
 {
     quint32 result = 0;
@@ -107,4 +125,42 @@ char* getVarint32PtrFallback(char* p, char* limit, quint32* value)
     return nullptr;
 }
 
+int encodeVarint64(char* dst, quint64 v)
+{
+    unsigned char* ptr = reinterpret_cast<unsigned char*>(dst);
+    static const int B = 128;
+    int pos = 0;
+    while (v >= B) {
+        ptr[pos++] = (v & (B - 1)) | B;
+        v >>= 7;
+    }
+    ptr[pos++] = static_cast<unsigned char>(v);
+    return pos;
+}
+
+void putVarint64(QByteArray* dst, quint64 v)
+{
+    char buf[10];
+    const int len = encodeVarint64(buf, v);
+    dst->append(buf, len);
+}
+
+const char* getVarint64PtrFallback(const char* p, const char* limit, quint64* value)
+{
+    quint64 result = 0;
+    for (quint32 shift = 0; shift <= 63 && p < limit; shift += 7) {
+        quint64 byte = *(reinterpret_cast<const unsigned char*>(p));
+        p++;
+        if (byte & 128) {
+            // More bytes are present
+            result |= ((byte & 127) << shift);
+        } else {
+            result |= (byte << shift);
+            *value = result;
+            return p;
+        }
+    }
+    return nullptr;
+}
+
 }
@@ -25,6 +25,11 @@ inline void putFixed64(QByteArray* dst, quint64 value)
     dst->append(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
+inline void putFixed32(QByteArray* dst, quint32 value)
+{
+    dst->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 /*
  * temporaryStorage is used to avoid an internal allocation of a temporary
  * buffer which is needed for serialization. Since this function is normally
@@ -33,8 +38,21 @@ inline void putFixed64(QByteArray* dst, quint64 value)
  */
 void putDifferentialVarInt32(QByteArray &temporaryStorage, QByteArray* dst, const QVector<quint32>& values);
 char* getDifferentialVarInt32(char* input, char* limit, QVector<quint32>* values);
+/*
+ * Skips over a list written by putDifferentialVarInt32 without decoding
+ * the values. Returns a pointer past the list, or nullptr for corrupt data.
+ */
+const char* skipDifferentialVarInt32(const char* input, const char* limit);
 extern const char* getVarint32Ptr(const char* p, const char* limit, quint32* v);
 
+/*
+ * Variable length encoding of 64 bit values, using 1 to 10 bytes.
+ * encodeVarint64 writes into \p dst, which must have room for 10 bytes,
+ * and returns the number of bytes written.
+ */
+int encodeVarint64(char* dst, quint64 value);
+void putVarint64(QByteArray* dst, quint64 value);
+
 inline quint64 decodeFixed64(const char* ptr)
 {
     // Load the raw bytes
@@ -43,6 +61,13 @@ inline quint64 decodeFixed64(const char* ptr)
     return result;
 }
 
+inline quint32 decodeFixed32(const char* ptr)
+{
+    quint32 result;
+    memcpy(&result, ptr, sizeof(result));
+    return result;
+}
+
 // Internal routine for use by fallback path of GetVarint32Ptr
 extern char* getVarint32PtrFallback(char* p, char* limit, quint32* value);
 inline char* getVarint32Ptr(char* p, char* limit, quint32* value)
@@ -60,6 +85,22 @@ inline char* getVarint32Ptr(char* p, char* limit, quint32* value)
     return getVarint32PtrFallback(p, limit, value);
 }
 
+extern const char* getVarint64PtrFallback(const char* p, const char* limit, quint64* value);
+inline const char* getVarint64Ptr(const char* p, const char* limit, quint64* value)
+{
+    if (p >= limit) {
+        return nullptr;
+    }
+
+    quint64 result = *(reinterpret_cast<const unsigned char*>(p));
+    if ((result & 128) == 0) {
+        *value = result;
+        return p + 1;
+    }
+
+    return getVarint64PtrFallback(p, limit, value);
+}
+
 }
 
 #endif
@@ -45,3 +45,39 @@ QVector<PositionInfo> PositionCodec::decode(const QByteArray& arr)
 
     return vec;
 }
+
+//
+// PositionListReader
+//
+PositionListReader::PositionListReader(const char* data, int size)
+    : m_next(data)
+    , m_end(data + size)
+{
+}
+
+quint64 PositionListReader::next()
+{
+    if (m_positions) {
+        m_next = skipDifferentialVarInt32(m_positions, m_end);
+    }
+
+    if (!m_next || m_end - m_next < static_cast<qint64>(sizeof(quint64))) {
+        m_next = nullptr;
+        m_positions = nullptr;
+        m_docId = 0;
+        return 0;
+    }
+
+    m_docId = decodeFixed64(m_next);
+    m_positions = m_next + sizeof(quint64);
+    return m_docId;
+}
+
+QVector<uint> PositionListReader::positions() const
+{
+    QVector<uint> positions;
+    if (m_positions) {
+        getDifferentialVarInt32(const_cast<char*>(m_positions), const_cast<char*>(m_end), &positions);
+    }
+    return positions;
+}
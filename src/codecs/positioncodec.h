@@ -21,6 +21,40 @@ public:
     static QByteArray encode(const QVector<PositionInfo>& list);
     static QVector<PositionInfo> decode(const QByteArray& arr);
 };
+
+/**
+ * Walks a list encoded by PositionCodec entry by entry. The positions
+ * are only decoded on request.
+ *
+ * The reader does not copy the data, it has to stay valid for the
+ * lifetime of the reader.
+ */
+class PositionListReader
+{
+public:
+    PositionListReader(const char* data, int size);
+
+    /**
+     * Advances to the next entry and returns its docId, or 0 when the
+     * end has been reached.
+     */
+    quint64 next();
+
+    quint64 docId() const {
+        return m_docId;
+    }
+
+    /**
+     * Decodes the positions of the current entry
+     */
+    QVector<uint> positions() const;
+
+private:
+    const char* m_positions = nullptr;
+    const char* m_next;
+    const char* m_end;
+    quint64 m_docId = 0;
+};
 }
 
 #endif // BALOO_POSITIONCODEC_H
@@ -6,22 +6,178 @@
 */
 
 #include "postingcodec.h"
+#include "coding.h"
+
+#include <algorithm>
 
 using namespace Baloo;
 
+namespace {
+// Each directory entry holds the last id (fixed64) and the offset (fixed32) of a block
+constexpr int DirectoryEntrySize = sizeof(quint64) + sizeof(quint32);
+}
+
 QByteArray PostingCodec::encode(const QVector<quint64>& list)
 {
-    uint size = list.size() * sizeof(quint64);
-    const char* ptr = reinterpret_cast<const char*>(list.constData());
+    const int blockCount = (list.size() + BlockSize - 1) / BlockSize;
+
+    // Worst case of 10 bytes per VarInt64
+    QByteArray blockData;
+    blockData.resize(10 * list.size());
+    char* ptr = blockData.data();
+    int pos = 0;
+
+    QByteArray directory;
+    if (blockCount > 1) {
+        directory.reserve(blockCount * DirectoryEntrySize);
+    }
 
-    return QByteArray(ptr, size);
+    quint64 prev = 0;
+    for (int i = 0; i < list.size(); i++) {
+        if (blockCount > 1 && i % BlockSize == 0) {
+            const int last = std::min(i + BlockSize, int(list.size())) - 1;
+            putFixed64(&directory, list[last]);
+            putFixed32(&directory, pos);
+        }
+        const quint64 id = list[i];
+        Q_ASSERT(id >= prev);
+        pos += encodeVarint64(ptr + pos, id - prev);
+        prev = id;
+    }
+    blockData.resize(pos);
+
+    QByteArray data;
+    data.reserve(11 + directory.size() + blockData.size());
+    data.append(FormatVersion);
+    putVarint64(&data, list.size());
+    data.append(directory);
+    data.append(blockData);
+
+    return data;
 }
 
 QVector<quint64> PostingCodec::decode(const QByteArray& arr)
 {
+    PostingBlockReader reader(arr.constData(), arr.size());
+    if (!reader.isValid()) {
+        return QVector<quint64>();
+    }
+
     QVector<quint64> vec;
-    vec.resize(arr.size() / sizeof(quint64));
+    vec.resize(reader.size());
+
+    quint64* ptr = vec.data();
+    for (int block = 0; block < reader.blockCount(); block++) {
+        const int len = reader.decodeBlock(block, ptr);
+        if (!len) {
+            return QVector<quint64>();
+        }
+        ptr += len;
+    }
 
-    memcpy(vec.data(), arr.constData(), arr.size());
     return vec;
 }
+
+//
+// PostingBlockReader
+//
+PostingBlockReader::PostingBlockReader(const char* data, int size)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    if (p == end || *p != PostingCodec::FormatVersion) {
+        return;
+    }
+    p++;
+
+    quint64 count = 0;
+    p = getVarint64Ptr(p, end, &count);
+    // Every id takes at least one byte, anything else is corrupt data
+    if (!p || count > static_cast<quint64>(end - p)) {
+        return;
+    }
+    const int blockCount = (count + PostingCodec::BlockSize - 1) / PostingCodec::BlockSize;
+
+    if (blockCount > 1) {
+        const qint64 directorySize = qint64(blockCount) * DirectoryEntrySize;
+        if (directorySize > end - p) {
+            return;
+        }
+        m_directory = p;
+        p += directorySize;
+    }
+
+    m_blockData = p;
+    m_end = end;
+    m_size = count;
+    m_blockCount = blockCount;
+}
+
+quint64 PostingBlockReader::lastId(int block) const
+{
+    Q_ASSERT(m_directory);
+    return decodeFixed64(m_directory + block * DirectoryEntrySize);
+}
+
+quint32 PostingBlockReader::blockOffset(int block) const
+{
+    if (!m_directory) {
+        return 0;
+    }
+    return decodeFixed32(m_directory + block * DirectoryEntrySize + sizeof(quint64));
+}
+
+int PostingBlockReader::findBlock(quint64 id, int fromBlock) const
+{
+    if (!m_directory) {
+        // Without a directory there is at most a single block
+        return fromBlock > 0 ? m_blockCount : 0;
+    }
+    if (fromBlock >= m_blockCount) {
+        return m_blockCount;
+    }
+
+    // Binary search for the first block with lastId >= id
+    int lo = std::max(fromBlock, 0);
+    int hi = m_blockCount;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (lastId(mid) < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int PostingBlockReader::decodeBlock(int block, quint64* ids) const
+{
+    Q_ASSERT(block >= 0 && block < m_blockCount);
+
+    const char* p = m_blockData + blockOffset(block);
+    if (p >= m_end) {
+        return 0;
+    }
+
+    // Deltas of each block are relative to the last id of the previous block
+    quint64 id = block > 0 ? lastId(block - 1) : 0;
+
+    int len = PostingCodec::BlockSize;
+    if (block == m_blockCount - 1) {
+        len = m_size - quint64(block) * PostingCodec::BlockSize;
+    }
+
+    for (int i = 0; i < len; i++) {
+        quint64 delta = 0;
+        p = getVarint64Ptr(p, m_end, &delta);
+        if (!p) {
+            return 0;
+        }
+        id += delta;
+        ids[i] = id;
+    }
+
+    return len;
+}
@@ -13,11 +13,80 @@
 
 namespace Baloo {
 
+/**
+ * Serializes a sorted list of document ids.
+ *
+ * The encoded value starts with a format version byte and the number of
+ * ids. The ids are split into blocks of BlockSize ids, each id stored as
+ * the VarInt64 encoded difference to its predecessor. As the ids are sorted
+ * and typically dense, most ids take only 1 or 2 bytes instead of 8.
+ *
+ * Lists with more than one block are preceded by a block directory, holding
+ * the last id and the data offset of each block as fixed size values. This
+ * allows PostingBlockReader to skip over blocks without decoding them.
+ */
 class PostingCodec
 {
 public:
     static QByteArray encode(const QVector<quint64>& list);
     static QVector<quint64> decode(const QByteArray& arr);
+
+    /**
+     * Version of the format written by encode(). Values with any
+     * other version are treated as empty by decode().
+     */
+    static constexpr char FormatVersion = 2;
+    static constexpr int BlockSize = 128;
+};
+
+/**
+ * Provides block wise access to a list encoded by PostingCodec.
+ *
+ * The reader does not copy \p data, it has to stay valid for the
+ * lifetime of the reader.
+ */
+class PostingBlockReader
+{
+public:
+    PostingBlockReader(const char* data, int size);
+
+    bool isValid() const {
+        return m_blockData != nullptr;
+    }
+
+    /**
+     * Total number of ids in the list
+     */
+    quint64 size() const {
+        return m_size;
+    }
+
+    int blockCount() const {
+        return m_blockCount;
+    }
+
+    /**
+     * Returns the index of the first block starting at \p fromBlock which
+     * may contain an id >= \p id, or blockCount() if there is none.
+     */
+    int findBlock(quint64 id, int fromBlock) const;
+
+    /**
+     * Decodes block \p block into \p ids, which must have room for
+     * PostingCodec::BlockSize values. Returns the number of ids decoded,
+     * or 0 if the data is corrupt.
+     */
+    int decodeBlock(int block, quint64* ids) const;
+
+private:
+    quint64 lastId(int block) const;
+    quint32 blockOffset(int block) const;
+
+    const char* m_directory = nullptr;
+    const char* m_blockData = nullptr;
+    const char* m_end = nullptr;
+    quint64 m_size = 0;
+    int m_blockCount = 0;
 };
 
 }
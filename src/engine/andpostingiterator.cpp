@@ -7,16 +7,41 @@
 
 #include "andpostingiterator.h"
 
+#include <algorithm>
+#include <numeric>
+
 using namespace Baloo;
 
 AndPostingIterator::AndPostingIterator(const QVector<PostingIterator*>& iterators)
     : m_iterators(iterators)
     , m_docId(0)
 {
-    if (m_iterators.contains(nullptr)) {
+    QVector<quint64> sizes;
+    sizes.reserve(m_iterators.size());
+    for (const PostingIterator* iter : std::as_const(m_iterators)) {
+        sizes << (iter ? iter->estimatedSize() : 0);
+    }
+
+    // An empty sub iterator makes the whole intersection empty
+    if (sizes.contains(0)) {
         qDeleteAll(m_iterators);
         m_iterators.clear();
+        return;
     }
+
+    // Rarest first
+    QVector<int> order(m_iterators.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](int lhs, int rhs) {
+        return sizes[lhs] < sizes[rhs];
+    });
+
+    QVector<PostingIterator*> sorted;
+    sorted.reserve(m_iterators.size());
+    for (int i : std::as_const(order)) {
+        sorted << m_iterators[i];
+    }
+    m_iterators = sorted;
 }
 
 AndPostingIterator::~AndPostingIterator()
@@ -29,6 +54,12 @@ quint64 AndPostingIterator::docId() const
     return m_docId;
 }
 
+quint64 AndPostingIterator::estimatedSize() const
+{
+    // The sub iterators are sorted by size
+    return m_iterators.isEmpty() ? 0 : m_iterators.first()->estimatedSize();
+}
+
 quint64 AndPostingIterator::skipTo(quint64 id)
 {
     if (m_iterators.isEmpty()) {
@@ -13,6 +13,13 @@
 
 namespace Baloo {
 
+/**
+ * Returns the intersection of the docIds of all its sub iterators.
+ *
+ * The sub iterators are driven in order of their estimatedSize(), so each
+ * round starts with the rarest one and the larger ones are only skipped
+ * to its candidates.
+ */
 class BALOO_ENGINE_EXPORT AndPostingIterator : public PostingIterator
 {
 public:
@@ -22,6 +29,7 @@ public:
     quint64 next() override;
     quint64 docId() const override;
     quint64 skipTo(quint64 docId) override;
+    quint64 estimatedSize() const override;
 
 private:
     QVector<PostingIterator*> m_iterators;
@@ -0,0 +1,602 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "bulkloader.h"
+#include "document.h"
+#include "postingdb.h"
+#include "positiondb.h"
+#include "positioninfo.h"
+#include "termchunkdb.h"
+#include "coding.h"
+#include "doctermscodec.h"
+#include "postingcodec.h"
+#include "positioncodec.h"
+#include "enginedebug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <vector>
+
+using namespace Baloo;
+
+namespace {
+/*
+ * Records are stored as the key size, payload size (both Fixed32), the
+ * id (Fixed64), followed by the key and the payload. The same layout is
+ * used in memory and in the run files.
+ */
+constexpr int RecordHeaderSize = 16;
+
+struct Record {
+    QByteArray key;
+    quint64 id = 0;
+    QByteArray payload;
+};
+
+Record recordAt(const char* data)
+{
+    const quint32 keySize = decodeFixed32(data);
+    const quint32 payloadSize = decodeFixed32(data + 4);
+
+    Record record;
+    record.id = decodeFixed64(data + 8);
+    record.key = QByteArray::fromRawData(data + RecordHeaderSize, keySize);
+    record.payload = QByteArray::fromRawData(data + RecordHeaderSize + keySize, payloadSize);
+    return record;
+}
+
+int recordSize(const char* data)
+{
+    return RecordHeaderSize + decodeFixed32(data) + decodeFixed32(data + 4);
+}
+
+bool lessThan(const Record& lhs, const Record& rhs)
+{
+    if (lhs.key != rhs.key) {
+        return lhs.key < rhs.key;
+    }
+    return lhs.id < rhs.id;
+}
+
+/*
+ * Reads the records of a run file sequentially
+ */
+class RunReader
+{
+public:
+    static constexpr int BufferSize = 256 * 1024;
+
+    explicit RunReader(const QString& fileName)
+        : m_file(fileName)
+    {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            qCWarning(ENGINE) << "BulkLoader: Could not open" << fileName << m_file.errorString();
+        }
+    }
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    /*
+     * Moves to the next record. The previous record becomes invalid.
+     */
+    bool next()
+    {
+        m_pos += m_recordSize;
+        m_recordSize = 0;
+
+        if (!fill(RecordHeaderSize)) {
+            return false;
+        }
+        const int size = recordSize(m_buffer.constData() + m_pos);
+        if (!fill(size)) {
+            qCWarning(ENGINE) << "BulkLoader: Truncated run" << m_file.fileName();
+            m_failed = true;
+            return false;
+        }
+
+        m_record = recordAt(m_buffer.constData() + m_pos);
+        m_recordSize = size;
+        return true;
+    }
+
+    const Record& record() const
+    {
+        return m_record;
+    }
+
+    bool hasFailed() const
+    {
+        return m_failed || !m_file.isOpen();
+    }
+
+private:
+    bool fill(int size)
+    {
+        if (m_buffer.size() - m_pos >= size) {
+            return true;
+        }
+        if (!m_file.isOpen()) {
+            return false;
+        }
+
+        m_buffer.remove(0, m_pos);
+        m_pos = 0;
+        while (m_buffer.size() < size) {
+            const QByteArray data = m_file.read(std::max<qint64>(BufferSize, size - m_buffer.size()));
+            if (data.isEmpty()) {
+                if (!m_buffer.isEmpty()) {
+                    m_failed = true;
+                }
+                return false;
+            }
+            m_buffer.append(data);
+        }
+        return true;
+    }
+
+    QFile m_file;
+    QByteArray m_buffer;
+    int m_pos = 0;
+    int m_recordSize = 0;
+    Record m_record;
+    bool m_failed = false;
+};
+}
+
+namespace Baloo {
+/*
+ * External sort of records by key and id. Records with the same key and id
+ * keep the order in which they were added.
+ */
+class SortedRuns
+{
+public:
+    SortedRuns(const QString& directory, const QString& name, qint64 memoryBudget)
+        : m_directory(directory)
+        , m_name(name)
+        , m_memoryBudget(memoryBudget)
+    {
+    }
+
+    ~SortedRuns()
+    {
+        for (const QString& run : std::as_const(m_runs)) {
+            QFile::remove(run);
+        }
+    }
+
+    SortedRuns(const SortedRuns&) = delete;
+    SortedRuns& operator=(const SortedRuns&) = delete;
+
+    void add(const QByteArray& key, quint64 id, const QByteArray& payload)
+    {
+        m_offsets.append(m_buffer.size());
+        putFixed32(&m_buffer, key.size());
+        putFixed32(&m_buffer, payload.size());
+        putFixed64(&m_buffer, id);
+        m_buffer.append(key);
+        m_buffer.append(payload);
+
+        if (m_buffer.size() + m_offsets.size() * qint64(sizeof(qsizetype)) > m_memoryBudget) {
+            spill();
+        }
+    }
+
+    /*
+     * Starts reading the records in sorted order, see top() and pop().
+     * No more records can be added afterwards.
+     */
+    bool startMerge()
+    {
+        if (!m_offsets.isEmpty()) {
+            spill();
+        }
+        if (m_failed) {
+            return false;
+        }
+
+        m_readers.reserve(m_runs.size());
+        for (const QString& run : std::as_const(m_runs)) {
+            m_readers.push_back(std::make_unique<RunReader>(run));
+        }
+        for (int i = 0; i < int(m_readers.size()); i++) {
+            if (m_readers[i]->next()) {
+                m_heap.push(i);
+            }
+        }
+        return true;
+    }
+
+    /*
+     * The smallest remaining record, nullptr once all records have been
+     * read. It stays valid until pop() is called.
+     */
+    const Record* top() const
+    {
+        return m_heap.empty() ? nullptr : &m_readers[m_heap.top()]->record();
+    }
+
+    void pop()
+    {
+        const int i = m_heap.top();
+        m_heap.pop();
+        if (m_readers[i]->next()) {
+            m_heap.push(i);
+        }
+    }
+
+    bool hasFailed() const
+    {
+        if (m_failed) {
+            return true;
+        }
+        for (const auto& reader : m_readers) {
+            if (reader->hasFailed()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void spill()
+    {
+        std::stable_sort(m_offsets.begin(), m_offsets.end(), [this](qsizetype lhs, qsizetype rhs) {
+            return lessThan(recordAt(m_buffer.constData() + lhs), recordAt(m_buffer.constData() + rhs));
+        });
+
+        const QString fileName = m_directory + QLatin1Char('/') + m_name + QLatin1Char('-') + QString::number(m_runs.size());
+        m_runs << fileName;
+
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(ENGINE) << "BulkLoader: Could not create" << fileName << file.errorString();
+            m_failed = true;
+        }
+        for (qsizetype offset : std::as_const(m_offsets)) {
+            if (m_failed) {
+                break;
+            }
+            const char* data = m_buffer.constData() + offset;
+            const int size = recordSize(data);
+            if (file.write(data, size) != size) {
+                qCWarning(ENGINE) << "BulkLoader: Could not write" << fileName << file.errorString();
+                m_failed = true;
+            }
+        }
+        if (file.isOpen() && !file.flush()) {
+            m_failed = true;
+        }
+
+        m_buffer.clear();
+        m_offsets.clear();
+    }
+
+    // Ties go to the earlier run, which contains the records added first
+    struct Greater {
+        const SortedRuns* runs;
+        bool operator()(int lhs, int rhs) const
+        {
+            const Record& l = runs->m_readers[lhs]->record();
+            const Record& r = runs->m_readers[rhs]->record();
+            if (lessThan(r, l)) {
+                return true;
+            }
+            return !lessThan(l, r) && lhs > rhs;
+        }
+    };
+
+    QString m_directory;
+    QString m_name;
+    qint64 m_memoryBudget;
+
+    QByteArray m_buffer;
+    QVector<qsizetype> m_offsets;
+    QStringList m_runs;
+    bool m_failed = false;
+
+    std::vector<std::unique_ptr<RunReader>> m_readers;
+    std::priority_queue<int, std::vector<int>, Greater> m_heap{Greater{this}};
+};
+}
+
+namespace {
+/*
+ * Appends to a database through a cursor. The keys have to be passed in
+ * the order of the database.
+ */
+class Appender
+{
+public:
+    Appender(MDB_dbi dbi, MDB_txn* txn)
+    {
+        int rc = mdb_cursor_open(txn, dbi, &m_cursor);
+        if (rc) {
+            qCWarning(ENGINE) << "BulkLoader: Could not open cursor" << mdb_strerror(rc);
+            m_cursor = nullptr;
+            m_failed = true;
+        }
+    }
+
+    ~Appender()
+    {
+        if (m_cursor) {
+            mdb_cursor_close(m_cursor);
+        }
+    }
+
+    Appender(const Appender&) = delete;
+    Appender& operator=(const Appender&) = delete;
+
+    void append(const QByteArray& key, const QByteArray& data)
+    {
+        if (m_failed) {
+            return;
+        }
+
+        MDB_val k;
+        k.mv_size = key.size();
+        k.mv_data = static_cast<void*>(const_cast<char*>(key.constData()));
+
+        MDB_val val;
+        val.mv_size = data.size();
+        val.mv_data = static_cast<void*>(const_cast<char*>(data.constData()));
+
+        int rc = mdb_cursor_put(m_cursor, &k, &val, MDB_APPEND);
+        if (rc) {
+            qCWarning(ENGINE) << "BulkLoader: Could not append" << key << mdb_strerror(rc);
+            m_failed = true;
+        }
+    }
+
+    bool hasFailed() const
+    {
+        return m_failed;
+    }
+
+private:
+    MDB_cursor* m_cursor = nullptr;
+    bool m_failed = false;
+};
+
+/*
+ * Splits the sorted ids and positions of a term into chunks, like
+ * PostingDB::put() and PositionDB::put() do.
+ */
+class TermWriter
+{
+public:
+    TermWriter(Appender& postings, Appender& positions)
+        : m_postings(postings)
+        , m_positions(positions)
+    {
+    }
+
+    void add(const Record& record)
+    {
+        if (record.key != m_term) {
+            flush();
+            m_term = record.key;
+            m_term.detach();
+            m_firstPostingChunk = true;
+            m_firstPositionChunk = true;
+            m_lastId = 0;
+            m_lastPositionId = 0;
+        }
+
+        // The same term can be added several times for one document, the first one wins
+        if (record.id != m_lastId) {
+            if (m_ids.size() == PostingDB::ChunkSize) {
+                flushPostings();
+            }
+            m_ids.append(record.id);
+            m_lastId = record.id;
+        }
+
+        if (!record.payload.isEmpty() && record.id != m_lastPositionId) {
+            if (m_positionInfos.size() == PositionDB::ChunkSize) {
+                flushPositions();
+            }
+            PositionInfo info(record.id);
+            const char* p = record.payload.constData();
+            const char* limit = p + record.payload.size();
+            while (p && p < limit) {
+                quint64 pos;
+                p = getVarint64Ptr(p, limit, &pos);
+                if (p) {
+                    info.positions.append(pos);
+                }
+            }
+            m_positionInfos.append(info);
+            m_lastPositionId = record.id;
+        }
+    }
+
+    const QByteArray& term() const
+    {
+        return m_term;
+    }
+
+    void flush()
+    {
+        if (!m_ids.isEmpty()) {
+            flushPostings();
+        }
+        if (!m_positionInfos.isEmpty()) {
+            flushPositions();
+        }
+    }
+
+private:
+    void flushPostings()
+    {
+        const quint64 start = m_firstPostingChunk ? 0 : m_ids.first();
+        m_postings.append(TermChunkDB::key(m_term, start), PostingCodec::encode(m_ids));
+        m_firstPostingChunk = false;
+        m_ids.clear();
+    }
+
+    void flushPositions()
+    {
+        const quint64 start = m_firstPositionChunk ? 0 : m_positionInfos.first().docId;
+        m_positions.append(TermChunkDB::key(m_term, start), PositionCodec::encode(m_positionInfos));
+        m_firstPositionChunk = false;
+        m_positionInfos.clear();
+    }
+
+    Appender& m_postings;
+    Appender& m_positions;
+
+    QByteArray m_term;
+    PostingList m_ids;
+    QVector<PositionInfo> m_positionInfos;
+    bool m_firstPostingChunk = true;
+    bool m_firstPositionChunk = true;
+    quint64 m_lastId = 0;
+    quint64 m_lastPositionId = 0;
+};
+
+enum DocTermsKind : char {
+    DocTerms = 't',
+    DocXattrTerms = 'x',
+    DocFileNameTerms = 'f',
+};
+}
+
+BulkLoader::BulkLoader(const QString& runDirectory, qint64 memoryBudget, qint64 transactionSize)
+    : m_runDirectory(runDirectory)
+    , m_valid(QDir().mkpath(runDirectory))
+    , m_transactionSize(transactionSize)
+    , m_termRuns(std::make_unique<SortedRuns>(runDirectory, QStringLiteral("terms"), memoryBudget / 4 * 3))
+    , m_docTermRuns(std::make_unique<SortedRuns>(runDirectory, QStringLiteral("docterms"), memoryBudget / 4))
+{
+    if (!m_valid) {
+        qCWarning(ENGINE) << "BulkLoader: Could not create" << runDirectory;
+    }
+}
+
+BulkLoader::~BulkLoader()
+{
+}
+
+QString BulkLoader::runDirectory(const QString& dbPath)
+{
+    return dbPath + QStringLiteral("/index-bulkload");
+}
+
+bool BulkLoader::isValid() const
+{
+    return m_valid;
+}
+
+void BulkLoader::addDocument(const Document& doc)
+{
+    const quint64 id = doc.id();
+
+    QByteArray payload;
+    auto addTerms = [&](DocTermsKind kind, const TermStore& terms) {
+        QVector<QByteArray> termList;
+        termList.reserve(terms.size());
+
+        for (int i = 0; i < terms.size(); ++i) {
+            const TermStore::Entry entry = terms.at(i);
+            termList.append(entry.term().toByteArray());
+
+            payload.clear();
+            for (int p = 0; p < entry.positionCount(); ++p) {
+                putVarint64(&payload, entry.positionData()[p]);
+            }
+            m_termRuns->add(termList.last(), id, payload);
+        }
+
+        if (!termList.isEmpty()) {
+            m_docTermRuns->add(QByteArray(1, kind), id, DocTermsCodec::encode(termList));
+        }
+    };
+
+    Q_ASSERT(!doc.m_terms.isEmpty());
+    addTerms(DocTerms, doc.m_terms);
+    addTerms(DocXattrTerms, doc.m_xattrTerms);
+    addTerms(DocFileNameTerms, doc.m_fileNameTerms);
+}
+
+bool BulkLoader::finish(const DatabaseDbis& dbis, MDB_txn* txn, bool& done)
+{
+    done = false;
+    if (!m_merging) {
+        m_merging = true;
+        if (!m_termRuns->startMerge() || !m_docTermRuns->startMerge()) {
+            return false;
+        }
+    }
+
+    // The record sizes approximate the size of the written values
+    qint64 written = 0;
+
+    {
+        Appender postings(dbis.postingDbi, txn);
+        Appender positions(dbis.positionDBi, txn);
+        TermWriter writer(postings, positions);
+
+        // The chunks of a term are written within one transaction
+        const Record* record;
+        while ((record = m_termRuns->top())) {
+            if (written >= m_transactionSize && record->key != writer.term()) {
+                break;
+            }
+            writer.add(*record);
+            written += RecordHeaderSize + record->key.size() + record->payload.size();
+            m_termRuns->pop();
+        }
+        writer.flush();
+
+        if (m_termRuns->hasFailed() || postings.hasFailed() || positions.hasFailed()) {
+            return false;
+        }
+        if (record) {
+            return true;
+        }
+    }
+
+    Appender docTerms(dbis.docTermsDbi, txn);
+    Appender docXattrTerms(dbis.docXattrTermsDbi, txn);
+    Appender docFileNameTerms(dbis.docFilenameTermsDbi, txn);
+
+    const Record* record;
+    while ((record = m_docTermRuns->top()) && written < m_transactionSize) {
+        const QByteArray key(reinterpret_cast<const char*>(&record->id), sizeof(record->id));
+        switch (record->key.at(0)) {
+        case DocTerms:
+            docTerms.append(key, record->payload);
+            break;
+        case DocXattrTerms:
+            docXattrTerms.append(key, record->payload);
+            break;
+        case DocFileNameTerms:
+            docFileNameTerms.append(key, record->payload);
+            break;
+        }
+        written += RecordHeaderSize + record->key.size() + record->payload.size();
+        m_docTermRuns->pop();
+    }
+
+    if (m_docTermRuns->hasFailed() || docTerms.hasFailed() || docXattrTerms.hasFailed() || docFileNameTerms.hasFailed()) {
+        return false;
+    }
+    done = !record;
+    return true;
+}
+
+void BulkLoader::removeRunDirectory()
+{
+    QDir(m_runDirectory).removeRecursively();
+}
@@ -0,0 +1,92 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_BULKLOADER_H
+#define BALOO_BULKLOADER_H
+
+#include "engine_export.h"
+#include "databasedbis.h"
+
+#include <QString>
+#include <memory>
+
+#include <lmdb.h>
+
+namespace Baloo {
+
+class Document;
+class SortedRuns;
+
+/**
+ * Builds the term databases of an empty index in one go.
+ *
+ * Instead of updating the posting lists of every document as it is added,
+ * the (term, id, positions) tuples and the term lists of the documents are
+ * collected in memory, and written as sorted runs to the run directory
+ * whenever the memory budget is exceeded. finish() merges the runs and
+ * appends the PostingDB, PositionDB and document terms DBs in key order,
+ * using MDB_APPEND, spread over several transactions.
+ *
+ * The databases written by finish() have to be empty, and nothing else may
+ * write to them until it is done. The run directory
+ * doubles as a marker for an unfinished bulk load: it is only removed by
+ * removeRunDirectory(), after the result has been committed. If it still
+ * exists on startup, the index is incomplete and has to be rebuilt.
+ */
+class BALOO_ENGINE_EXPORT BulkLoader
+{
+public:
+    explicit BulkLoader(const QString& runDirectory, qint64 memoryBudget = DefaultMemoryBudget,
+                        qint64 transactionSize = DefaultTransactionSize);
+    ~BulkLoader();
+    BulkLoader(const BulkLoader&) = delete;
+    BulkLoader& operator=(const BulkLoader&) = delete;
+
+    static constexpr qint64 DefaultMemoryBudget = 64 * 1024 * 1024;
+    /// About the amount of data written by one call of finish()
+    static constexpr qint64 DefaultTransactionSize = 64 * 1024 * 1024;
+
+    /**
+     * The run directory used for the database in \p dbPath
+     */
+    static QString runDirectory(const QString& dbPath);
+
+    /**
+     * False if the run directory could not be created
+     */
+    bool isValid() const;
+
+    /**
+     * Collects the terms of \p doc. The remaining document data is not
+     * handled by the BulkLoader, see WriteTransaction::addDocument().
+     */
+    void addDocument(const Document& doc);
+
+    /**
+     * Writes the next part of the collected terms within \p txn, about
+     * the transaction size given to the constructor. Until \p done is set,
+     * \p txn is to be committed and finish() called again with a new one.
+     * No more documents can be added once it has been called. Returns false
+     * if writing any of the runs or the databases failed.
+     */
+    bool finish(const DatabaseDbis& dbis, MDB_txn* txn, bool& done);
+
+    void removeRunDirectory();
+
+private:
+    QString m_runDirectory;
+    bool m_valid;
+    qint64 m_transactionSize;
+    bool m_merging = false;
+
+    std::unique_ptr<SortedRuns> m_termRuns;
+    std::unique_ptr<SortedRuns> m_docTermRuns;
+};
+
+}
+
+#endif // BALOO_BULKLOADER_H
@@ -0,0 +1,219 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "contenthashdb.h"
+#include "enginedebug.h"
+
+using namespace Baloo;
+
+namespace {
+MDB_dbi openDb(MDB_txn* txn, const char* name, unsigned int flags)
+{
+    MDB_dbi dbi = 0;
+    int rc = mdb_dbi_open(txn, name, flags, &dbi);
+    if (rc) {
+        if (rc != MDB_NOTFOUND || (flags & MDB_CREATE)) {
+            qCWarning(ENGINE) << "ContentHashDB::open" << name << mdb_strerror(rc);
+        }
+        return 0;
+    }
+    return dbi;
+}
+}
+
+ContentHashDB::ContentHashDB(MDB_dbi idHashDbi, MDB_dbi hashIdDbi, MDB_txn* txn)
+    : m_txn(txn)
+    , m_idHashDbi(idHashDbi)
+    , m_hashIdDbi(hashIdDbi)
+{
+    Q_ASSERT(txn != nullptr);
+    Q_ASSERT((idHashDbi == 0) == (hashIdDbi == 0));
+}
+
+ContentHashDB::~ContentHashDB()
+{
+}
+
+MDB_dbi ContentHashDB::createIdHashDb(MDB_txn* txn)
+{
+    return openDb(txn, "contenthashdb", MDB_CREATE | MDB_INTEGERKEY);
+}
+
+MDB_dbi ContentHashDB::openIdHashDb(MDB_txn* txn)
+{
+    return openDb(txn, "contenthashdb", MDB_INTEGERKEY);
+}
+
+// All documents with a hash are kept as sorted duplicates, so removing
+// one of the copies leaves the others findable
+MDB_dbi ContentHashDB::createHashIdDb(MDB_txn* txn)
+{
+    return openDb(txn, "contenthashiddb", MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED | MDB_INTEGERDUP);
+}
+
+MDB_dbi ContentHashDB::openHashIdDb(MDB_txn* txn)
+{
+    return openDb(txn, "contenthashiddb", MDB_DUPSORT | MDB_DUPFIXED | MDB_INTEGERDUP);
+}
+
+void ContentHashDB::put(quint64 docId, const QByteArray& hash)
+{
+    Q_ASSERT(docId > 0);
+
+    if (!m_idHashDbi) {
+        return;
+    }
+
+    const QByteArray prevHash = get(docId);
+    if (prevHash == hash) {
+        return;
+    }
+    if (!prevHash.isEmpty()) {
+        del(docId);
+    }
+    if (hash.isEmpty()) {
+        return;
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&docId)};
+    MDB_val val{static_cast<size_t>(hash.size()), static_cast<void*>(const_cast<char*>(hash.constData()))};
+    int rc = mdb_put(m_txn, m_idHashDbi, &key, &val, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "ContentHashDB::put" << mdb_strerror(rc);
+        return;
+    }
+
+    rc = mdb_put(m_txn, m_hashIdDbi, &val, &key, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "ContentHashDB::put hash" << mdb_strerror(rc);
+    }
+}
+
+QByteArray ContentHashDB::get(quint64 docId) const
+{
+    Q_ASSERT(docId > 0);
+
+    if (!m_idHashDbi) {
+        return QByteArray();
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&docId)};
+    MDB_val val{0, nullptr};
+    int rc = mdb_get(m_txn, m_idHashDbi, &key, &val);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "ContentHashDB::get" << docId << mdb_strerror(rc);
+        }
+        return QByteArray();
+    }
+
+    return QByteArray(static_cast<char*>(val.mv_data), val.mv_size);
+}
+
+void ContentHashDB::del(quint64 docId)
+{
+    Q_ASSERT(docId > 0);
+
+    if (!m_idHashDbi) {
+        return;
+    }
+
+    const QByteArray hash = get(docId);
+    if (hash.isEmpty()) {
+        return;
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&docId)};
+    int rc = mdb_del(m_txn, m_idHashDbi, &key, nullptr);
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "ContentHashDB::del" << docId << mdb_strerror(rc);
+    }
+
+    // Only this copy, the others keep the hash
+    MDB_val hashKey{static_cast<size_t>(hash.size()), static_cast<void*>(const_cast<char*>(hash.constData()))};
+    rc = mdb_del(m_txn, m_hashIdDbi, &hashKey, &key);
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "ContentHashDB::del hash" << docId << mdb_strerror(rc);
+    }
+}
+
+quint64 ContentHashDB::documentWithHash(const QByteArray& hash) const
+{
+    if (!m_hashIdDbi || hash.isEmpty()) {
+        return 0;
+    }
+
+    MDB_cursor* cursor;
+    int rc = mdb_cursor_open(m_txn, m_hashIdDbi, &cursor);
+    if (rc) {
+        qCDebug(ENGINE) << "ContentHashDB::documentWithHash" << mdb_strerror(rc);
+        return 0;
+    }
+
+    // The ids are sorted, the last one is the newest document
+    MDB_val key{static_cast<size_t>(hash.size()), static_cast<void*>(const_cast<char*>(hash.constData()))};
+    MDB_val val{0, nullptr};
+    rc = mdb_cursor_get(cursor, &key, &val, MDB_SET_KEY);
+    if (rc == 0) {
+        rc = mdb_cursor_get(cursor, &key, &val, MDB_LAST_DUP);
+    }
+    quint64 id = 0;
+    if (rc == 0) {
+        id = *static_cast<quint64*>(val.mv_data);
+    } else if (rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "ContentHashDB::documentWithHash" << mdb_strerror(rc);
+    }
+
+    mdb_cursor_close(cursor);
+    return id;
+}
+
+bool ContentHashDB::hasHashWithPrefix(const QByteArray& prefix) const
+{
+    if (!m_hashIdDbi || prefix.isEmpty()) {
+        return false;
+    }
+
+    MDB_cursor* cursor;
+    int rc = mdb_cursor_open(m_txn, m_hashIdDbi, &cursor);
+    if (rc) {
+        qCDebug(ENGINE) << "ContentHashDB::hasHashWithPrefix" << mdb_strerror(rc);
+        return false;
+    }
+
+    MDB_val key{static_cast<size_t>(prefix.size()), static_cast<void*>(const_cast<char*>(prefix.constData()))};
+    MDB_val val{0, nullptr};
+    rc = mdb_cursor_get(cursor, &key, &val, MDB_SET_RANGE);
+    const bool found = rc == 0 && QByteArray::fromRawData(static_cast<char*>(key.mv_data), key.mv_size).startsWith(prefix);
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "ContentHashDB::hasHashWithPrefix" << mdb_strerror(rc);
+    }
+
+    mdb_cursor_close(cursor);
+    return found;
+}
+
+QMap<quint64, QByteArray> ContentHashDB::toTestMap() const
+{
+    QMap<quint64, QByteArray> map;
+    if (!m_idHashDbi) {
+        return map;
+    }
+
+    MDB_cursor* cursor;
+    mdb_cursor_open(m_txn, m_idHashDbi, &cursor);
+
+    MDB_val key{0, nullptr};
+    MDB_val val{0, nullptr};
+    while (mdb_cursor_get(cursor, &key, &val, MDB_NEXT) == 0) {
+        const quint64 id = *static_cast<quint64*>(key.mv_data);
+        map.insert(id, QByteArray(static_cast<char*>(val.mv_data), val.mv_size));
+    }
+
+    mdb_cursor_close(cursor);
+    return map;
+}
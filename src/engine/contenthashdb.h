@@ -0,0 +1,68 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_CONTENTHASHDB_H
+#define BALOO_CONTENTHASHDB_H
+
+#include "engine_export.h"
+#include <QByteArray>
+#include <QMap>
+#include <lmdb.h>
+
+namespace Baloo {
+
+/**
+ * Stores the hash of the file contents the terms and data of a document
+ * were extracted from. It maps the id to the hash, and the hash to all
+ * documents with it, so the contents of copies can be reused instead of
+ * extracting them again.
+ *
+ * The hash is optional, documents without one are always extracted. Like
+ * the content indexing queue, databases created before it existed do not
+ * have it when opened read-only. The dbis are 0 then, and all lookups
+ * return nothing.
+ */
+class BALOO_ENGINE_EXPORT ContentHashDB
+{
+public:
+    ContentHashDB(MDB_dbi idHashDbi, MDB_dbi hashIdDbi, MDB_txn* txn);
+    ~ContentHashDB();
+
+    static MDB_dbi createIdHashDb(MDB_txn* txn);
+    static MDB_dbi openIdHashDb(MDB_txn* txn);
+    static MDB_dbi createHashIdDb(MDB_txn* txn);
+    static MDB_dbi openHashIdDb(MDB_txn* txn);
+
+    /**
+     * Sets the hash of \p docId, an empty \p hash removes it
+     */
+    void put(quint64 docId, const QByteArray& hash);
+    QByteArray get(quint64 docId) const;
+    void del(quint64 docId);
+
+    /**
+     * Returns a document with the content \p hash, the newest one as long
+     * as it exists, or 0
+     */
+    quint64 documentWithHash(const QByteArray& hash) const;
+
+    /**
+     * Returns true if any document has a hash starting with \p prefix
+     */
+    bool hasHashWithPrefix(const QByteArray& prefix) const;
+
+    QMap<quint64, QByteArray> toTestMap() const;
+
+private:
+    MDB_txn* m_txn;
+    MDB_dbi m_idHashDbi;
+    MDB_dbi m_hashIdDbi;
+};
+
+}
+
+#endif // BALOO_CONTENTHASHDB_H
@@ -0,0 +1,245 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "contentindexingqueuedb.h"
+#include "document.h"
+#include "documentiddb.h"
+#include "documenttimedb.h"
+#include "enginedebug.h"
+
+#include <QPair>
+
+using namespace Baloo;
+
+ContentIndexingQueueDB::ContentIndexingQueueDB(MDB_dbi contentIndexingDbi, MDB_dbi queueDbi, MDB_txn* txn)
+    : m_txn(txn)
+    , m_contentIndexingDbi(contentIndexingDbi)
+    , m_queueDbi(queueDbi)
+{
+    Q_ASSERT(txn != nullptr);
+    Q_ASSERT(contentIndexingDbi != 0);
+}
+
+ContentIndexingQueueDB::~ContentIndexingQueueDB()
+{
+}
+
+MDB_dbi ContentIndexingQueueDB::create(MDB_txn* txn)
+{
+    MDB_dbi dbi = 0;
+    int rc = mdb_dbi_open(txn, "indexingqueuedb", MDB_CREATE | MDB_INTEGERKEY | MDB_DUPSORT | MDB_DUPFIXED | MDB_INTEGERDUP, &dbi);
+    if (rc) {
+        qCWarning(ENGINE) << "ContentIndexingQueueDB::create" << mdb_strerror(rc);
+        return 0;
+    }
+
+    return dbi;
+}
+
+MDB_dbi ContentIndexingQueueDB::open(MDB_txn* txn)
+{
+    MDB_dbi dbi = 0;
+    int rc = mdb_dbi_open(txn, "indexingqueuedb", MDB_INTEGERKEY | MDB_DUPSORT | MDB_DUPFIXED | MDB_INTEGERDUP, &dbi);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCWarning(ENGINE) << "ContentIndexingQueueDB::open" << mdb_strerror(rc);
+        }
+        return 0;
+    }
+
+    return dbi;
+}
+
+bool ContentIndexingQueueDB::priority(quint64 docId, quint32* priority) const
+{
+    MDB_val key;
+    key.mv_size = sizeof(quint64);
+    key.mv_data = static_cast<void*>(&docId);
+
+    MDB_val val{0, nullptr};
+    int rc = mdb_get(m_txn, m_contentIndexingDbi, &key, &val);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "ContentIndexingQueueDB::priority" << docId << mdb_strerror(rc);
+        }
+        return false;
+    }
+
+    if (val.mv_size != sizeof(quint32)) {
+        return false;
+    }
+    *priority = *static_cast<quint32*>(val.mv_data);
+    return true;
+}
+
+void ContentIndexingQueueDB::put(quint64 docId, quint32 priority)
+{
+    Q_ASSERT(docId > 0);
+
+    quint32 prevPriority = 0;
+    if (this->priority(docId, &prevPriority)) {
+        if (prevPriority == priority) {
+            return;
+        }
+        if (m_queueDbi) {
+            MDB_val key{sizeof(quint32), static_cast<void*>(&prevPriority)};
+            MDB_val val{sizeof(quint64), static_cast<void*>(&docId)};
+            mdb_del(m_txn, m_queueDbi, &key, &val);
+        }
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&docId)};
+    MDB_val val{sizeof(quint32), static_cast<void*>(&priority)};
+    int rc = mdb_put(m_txn, m_contentIndexingDbi, &key, &val, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "ContentIndexingQueueDB::put" << mdb_strerror(rc);
+        return;
+    }
+
+    if (m_queueDbi) {
+        MDB_val queueKey{sizeof(quint32), static_cast<void*>(&priority)};
+        MDB_val queueVal{sizeof(quint64), static_cast<void*>(&docId)};
+        rc = mdb_put(m_txn, m_queueDbi, &queueKey, &queueVal, 0);
+        if (rc) {
+            qCWarning(ENGINE) << "ContentIndexingQueueDB::put queue" << mdb_strerror(rc);
+        }
+    }
+}
+
+void ContentIndexingQueueDB::del(quint64 docId)
+{
+    Q_ASSERT(docId > 0);
+
+    quint32 prevPriority = 0;
+    if (priority(docId, &prevPriority) && m_queueDbi) {
+        MDB_val key{sizeof(quint32), static_cast<void*>(&prevPriority)};
+        MDB_val val{sizeof(quint64), static_cast<void*>(&docId)};
+        int rc = mdb_del(m_txn, m_queueDbi, &key, &val);
+        if (rc != 0 && rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "ContentIndexingQueueDB::del queue" << docId << mdb_strerror(rc);
+        }
+    }
+
+    DocumentIdDB contentIndexingDb(m_contentIndexingDbi, m_txn);
+    contentIndexingDb.del(docId);
+}
+
+QVector<quint64> ContentIndexingQueueDB::fetchItems(int size)
+{
+    Q_ASSERT(size > 0);
+
+    if (!m_queueDbi) {
+        DocumentIdDB contentIndexingDb(m_contentIndexingDbi, m_txn);
+        return contentIndexingDb.fetchItems(size);
+    }
+
+    MDB_cursor* cursor;
+    mdb_cursor_open(m_txn, m_queueDbi, &cursor);
+
+    QVector<quint64> vec;
+    vec.reserve(size);
+
+    for (int i = 0; i < size; i++) {
+        MDB_val key{0, nullptr};
+        MDB_val val{0, nullptr};
+        int rc = mdb_cursor_get(cursor, &key, &val, MDB_NEXT);
+        if (rc) {
+            if (rc != MDB_NOTFOUND) {
+                qCWarning(ENGINE) << "ContentIndexingQueueDB::fetchItems" << size << mdb_strerror(rc);
+            }
+            break;
+        }
+
+        vec << *static_cast<quint64*>(val.mv_data);
+    }
+    mdb_cursor_close(cursor);
+
+    return vec;
+}
+
+bool ContentIndexingQueueDB::isComplete() const
+{
+    if (!m_queueDbi) {
+        return false;
+    }
+
+    MDB_stat queueStat;
+    MDB_stat contentIndexingStat;
+    if (mdb_stat(m_txn, m_queueDbi, &queueStat) || mdb_stat(m_txn, m_contentIndexingDbi, &contentIndexingStat)) {
+        return false;
+    }
+    return queueStat.ms_entries == contentIndexingStat.ms_entries;
+}
+
+void ContentIndexingQueueDB::rebuild(MDB_dbi docTimeDbi)
+{
+    Q_ASSERT(m_queueDbi);
+
+    int rc = mdb_drop(m_txn, m_queueDbi, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "ContentIndexingQueueDB::rebuild" << mdb_strerror(rc);
+        return;
+    }
+
+    QVector<QPair<quint64, quint32>> entries;
+    QVector<quint64> missingPriority;
+    {
+        MDB_cursor* cursor;
+        mdb_cursor_open(m_txn, m_contentIndexingDbi, &cursor);
+
+        MDB_val key{0, nullptr};
+        MDB_val val{0, nullptr};
+        while (mdb_cursor_get(cursor, &key, &val, MDB_NEXT) == 0) {
+            const quint64 id = *static_cast<quint64*>(key.mv_data);
+            if (val.mv_size == sizeof(quint32)) {
+                entries.append({id, *static_cast<quint32*>(val.mv_data)});
+            } else {
+                missingPriority.append(id);
+            }
+        }
+        mdb_cursor_close(cursor);
+    }
+
+    DocumentTimeDB docTimeDb(docTimeDbi, m_txn);
+    for (quint64 id : std::as_const(missingPriority)) {
+        quint32 priority = Document::defaultContentIndexingPriority(docTimeDb.get(id).mTime);
+        MDB_val key{sizeof(quint64), static_cast<void*>(&id)};
+        MDB_val val{sizeof(quint32), static_cast<void*>(&priority)};
+        mdb_put(m_txn, m_contentIndexingDbi, &key, &val, 0);
+        entries.append({id, priority});
+    }
+
+    for (auto& entry : entries) {
+        MDB_val key{sizeof(quint32), static_cast<void*>(&entry.second)};
+        MDB_val val{sizeof(quint64), static_cast<void*>(&entry.first)};
+        rc = mdb_put(m_txn, m_queueDbi, &key, &val, 0);
+        if (rc) {
+            qCWarning(ENGINE) << "ContentIndexingQueueDB::rebuild put" << mdb_strerror(rc);
+            return;
+        }
+    }
+}
+
+QVector<quint64> ContentIndexingQueueDB::toTestVector() const
+{
+    QVector<quint64> vec;
+    if (!m_queueDbi) {
+        return vec;
+    }
+
+    MDB_cursor* cursor;
+    mdb_cursor_open(m_txn, m_queueDbi, &cursor);
+
+    MDB_val key{0, nullptr};
+    MDB_val val{0, nullptr};
+    while (mdb_cursor_get(cursor, &key, &val, MDB_NEXT) == 0) {
+        vec << *static_cast<quint64*>(val.mv_data);
+    }
+
+    mdb_cursor_close(cursor);
+    return vec;
+}
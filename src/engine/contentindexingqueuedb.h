@@ -0,0 +1,73 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_CONTENTINDEXINGQUEUEDB_H
+#define BALOO_CONTENTINDEXINGQUEUEDB_H
+
+#include "engine_export.h"
+#include <QVector>
+#include <lmdb.h>
+
+namespace Baloo {
+
+/**
+ * Orders the ids of the content indexing DB by their priority, lower values
+ * first, see Document::contentIndexingPriority(). Like the MTimeDB, the
+ * queue maps the priority to the ids. The content indexing DB stores the
+ * priority of each id as its value, so the queue entry can be removed again.
+ *
+ * Databases created before the queue existed do not have it. When opened
+ * read-only, the queue dbi is 0 and the ids are returned in id order.
+ * Otherwise the queue is rebuilt by rebuild().
+ */
+class BALOO_ENGINE_EXPORT ContentIndexingQueueDB
+{
+public:
+    ContentIndexingQueueDB(MDB_dbi contentIndexingDbi, MDB_dbi queueDbi, MDB_txn* txn);
+    ~ContentIndexingQueueDB();
+
+    static MDB_dbi create(MDB_txn* txn);
+
+    /**
+     * Returns 0 if the database does not have a queue yet
+     */
+    static MDB_dbi open(MDB_txn* txn);
+
+    void put(quint64 docId, quint32 priority);
+    void del(quint64 docId);
+
+    QVector<quint64> fetchItems(int size);
+
+    /**
+     * False if an id of the content indexing DB is missing in the queue,
+     * e.g. because it was added while the queue did not exist
+     */
+    bool isComplete() const;
+
+    /**
+     * Fills the queue from the content indexing DB. Ids without a stored
+     * priority get the default priority of their mtime.
+     */
+    void rebuild(MDB_dbi docTimeDbi);
+
+    QVector<quint64> toTestVector() const;
+
+private:
+    /**
+     * False if \p docId is not in the content indexing DB, or was added
+     * without a priority
+     */
+    bool priority(quint64 docId, quint32* priority) const;
+
+    MDB_txn* m_txn;
+    MDB_dbi m_contentIndexingDbi;
+    MDB_dbi m_queueDbi;
+};
+
+}
+
+#endif // BALOO_CONTENTINDEXINGQUEUEDB_H
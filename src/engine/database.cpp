@@ -12,6 +12,9 @@
 #include "documentdb.h"
 #include "documenturldb.h"
 #include "documentiddb.h"
+#include "contentindexingqueuedb.h"
+#include "contenthashdb.h"
+#include "folderfingerprintdb.h"
 #include "positiondb.h"
 #include "documenttimedb.h"
 #include "documentdatadb.h"
@@ -100,7 +103,7 @@ bool Database::open(OpenMode mode)
      * maximal number of allowed named databases, must match number of databases we create below
      * each additional one leads to overhead
      */
-    mdb_env_set_maxdbs(m_env, 12);
+    mdb_env_set_maxdbs(m_env, 16);
 
     /**
      * size limit for database == size limit of mmap
@@ -171,6 +174,13 @@ bool Database::open(OpenMode mode)
         m_dbis.docDataDbi = DocumentDataDB::open(txn);
 
         m_dbis.contentIndexingDbi = DocumentIdDB::open("indexingleveldb", txn);
+        m_dbis.contentIndexingQueueDbi = ContentIndexingQueueDB::open(txn);
+        m_dbis.contentHashDbi = ContentHashDB::openIdHashDb(txn);
+        m_dbis.contentHashIdDbi = ContentHashDB::openHashIdDb(txn);
+        if (!m_dbis.contentHashDbi || !m_dbis.contentHashIdDbi) {
+            m_dbis.contentHashDbi = m_dbis.contentHashIdDbi = 0;
+        }
+        m_dbis.folderFingerprintDbi = FolderFingerprintDB::open(txn);
         m_dbis.failedIdDbi = DocumentIdDB::open("failediddb", txn);
 
         m_dbis.mtimeDbi = MTimeDB::open(txn);
@@ -213,11 +223,16 @@ bool Database::open(OpenMode mode)
         m_dbis.docDataDbi = DocumentDataDB::create(txn);
 
         m_dbis.contentIndexingDbi = DocumentIdDB::create("indexingleveldb", txn);
+        m_dbis.contentIndexingQueueDbi = ContentIndexingQueueDB::create(txn);
+        m_dbis.contentHashDbi = ContentHashDB::createIdHashDb(txn);
+        m_dbis.contentHashIdDbi = ContentHashDB::createHashIdDb(txn);
+        m_dbis.folderFingerprintDbi = FolderFingerprintDB::create(txn);
         m_dbis.failedIdDbi = DocumentIdDB::create("failediddb", txn);
 
         m_dbis.mtimeDbi = MTimeDB::create(txn);
 
-        if (!m_dbis.isValid()) {
+        if (!m_dbis.isValid() || !m_dbis.contentIndexingQueueDbi || !m_dbis.contentHashDbi || !m_dbis.contentHashIdDbi
+            || !m_dbis.folderFingerprintDbi) {
             qCWarning(ENGINE) << "dbis is invalid";
             mdb_txn_abort(txn);
             mdb_env_close(m_env);
@@ -225,6 +240,14 @@ bool Database::open(OpenMode mode)
             return false;
         }
 
+        // The database was created before the queue existed, or the queue
+        // was missing when it was last written
+        ContentIndexingQueueDB queueDb(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, txn);
+        if (!queueDb.isComplete()) {
+            qCDebug(ENGINE) << "Rebuilding the content indexing queue";
+            queueDb.rebuild(m_dbis.docTimeDbi);
+        }
+
         rc = mdb_txn_commit(txn);
         if (rc) {
             qCWarning(ENGINE) << "Database::transaction commit" << mdb_strerror(rc);
@@ -27,6 +27,13 @@ public:
     MDB_dbi docTimeDbi = 0;
     MDB_dbi docDataDbi = 0;
     MDB_dbi contentIndexingDbi = 0;
+    // Optional, see ContentIndexingQueueDB
+    MDB_dbi contentIndexingQueueDbi = 0;
+    // Optional, see ContentHashDB
+    MDB_dbi contentHashDbi = 0;
+    MDB_dbi contentHashIdDbi = 0;
+    // Optional, see FolderFingerprintDB
+    MDB_dbi folderFingerprintDbi = 0;
 
     MDB_dbi mtimeDbi = 0;
     MDB_dbi failedIdDbi = 0;
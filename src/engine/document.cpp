@@ -7,6 +7,8 @@
 
 #include "document.h"
 
+#include <limits>
+
 using namespace Baloo;
 
 Document::Document() = default;
@@ -15,40 +17,47 @@ void Document::addTerm(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
     // This adds "term" without position data if it does not exist, otherwise it is a noop
-    m_terms[term];
+    m_terms.add(term);
 }
 
 void Document::addPositionTerm(const QByteArray& term, int position)
 {
     Q_ASSERT(!term.isEmpty());
-    TermData& td = m_terms[term];
-    td.positions.append(position);
+    m_terms.add(term, position);
+}
+
+int Document::termCount() const
+{
+    return m_terms.size();
+}
+
+bool Document::hasTerm(const QByteArray& term) const
+{
+    return m_terms.contains(term);
 }
 
 void Document::addXattrPositionTerm(const QByteArray& term, int position)
 {
     Q_ASSERT(!term.isEmpty());
-    TermData& td = m_xattrTerms[term];
-    td.positions.append(position);
+    m_xattrTerms.add(term, position);
 }
 
 void Document::addXattrTerm(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
-    m_xattrTerms[term];
+    m_xattrTerms.add(term);
 }
 
 void Document::addFileNamePositionTerm(const QByteArray& term, int position)
 {
     Q_ASSERT(!term.isEmpty());
-    TermData& td = m_fileNameTerms[term];
-    td.positions.append(position);
+    m_fileNameTerms.add(term, position);
 }
 
 void Document::addFileNameTerm(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
-    m_fileNameTerms[term];
+    m_fileNameTerms.add(term);
 }
 
 quint64 Document::id() const
@@ -94,7 +103,78 @@ void Document::setContentIndexing(bool val)
     m_contentIndexing = val;
 }
 
+void Document::setContentIndexingPriority(quint32 priority)
+{
+    m_contentIndexingPriority = priority;
+}
+
+quint32 Document::contentIndexingPriority() const
+{
+    if (m_contentIndexingPriority) {
+        return m_contentIndexingPriority;
+    }
+    return defaultContentIndexingPriority(m_mTime);
+}
+
+quint32 Document::defaultContentIndexingPriority(quint32 mTime)
+{
+    return std::numeric_limits<quint32>::max() - mTime;
+}
+
 void Document::setData(const QByteArray& data)
 {
     m_data = data;
 }
+
+QDataStream& Baloo::operator<<(QDataStream& stream, const Document& doc)
+{
+    auto writeTerms = [&stream](const TermStore& terms) {
+        stream << quint32(terms.size());
+        for (int i = 0; i < terms.size(); ++i) {
+            const TermStore::Entry entry = terms.at(i);
+            stream.writeBytes(entry.term().data(), entry.term().size());
+            stream << quint32(entry.positionCount());
+            for (int p = 0; p < entry.positionCount(); ++p) {
+                stream << quint32(entry.positionData()[p]);
+            }
+        }
+    };
+
+    stream << doc.m_id << doc.m_parentId << doc.m_url;
+    writeTerms(doc.m_terms);
+    writeTerms(doc.m_xattrTerms);
+    writeTerms(doc.m_fileNameTerms);
+    stream << doc.m_contentIndexing << doc.m_contentIndexingPriority << doc.m_mTime << doc.m_cTime << doc.m_data;
+    return stream;
+}
+
+QDataStream& Baloo::operator>>(QDataStream& stream, Document& doc)
+{
+    auto readTerms = [&stream](TermStore& terms) {
+        terms.clear();
+        quint32 count = 0;
+        stream >> count;
+        QByteArray term;
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+            quint32 positionCount = 0;
+            stream >> term >> positionCount;
+            if (term.isEmpty()) {
+                stream.setStatus(QDataStream::ReadCorruptData);
+                break;
+            }
+            terms.add(term);
+            for (quint32 p = 0; p < positionCount && stream.status() == QDataStream::Ok; p++) {
+                quint32 position = 0;
+                stream >> position;
+                terms.add(term, position);
+            }
+        }
+    };
+
+    stream >> doc.m_id >> doc.m_parentId >> doc.m_url;
+    readTerms(doc.m_terms);
+    readTerms(doc.m_xattrTerms);
+    readTerms(doc.m_fileNameTerms);
+    stream >> doc.m_contentIndexing >> doc.m_contentIndexingPriority >> doc.m_mTime >> doc.m_cTime >> doc.m_data;
+    return stream;
+}
@@ -9,7 +9,9 @@
 #define BALOO_DOCUMENT_H
 
 #include "engine_export.h"
+#include "termstore.h"
 #include <QByteArray>
+#include <QDataStream>
 #include <QDebug>
 #include <QVector>
 
@@ -35,6 +37,19 @@ public:
     void addTerm(const QByteArray& term);
     void addPositionTerm(const QByteArray& term, int position = 0);
 
+    /**
+     * Only the first positions of a term are kept, further occurrences
+     * are dropped. This keeps the memory bounded for large files, at the
+     * cost of phrase matches far into them.
+     */
+    static constexpr int maxTermPositions = TermStore::maxPositions;
+
+    /**
+     * The number of distinct terms added with addTerm() and addPositionTerm()
+     */
+    int termCount() const;
+    bool hasTerm(const QByteArray& term) const;
+
     void addXattrTerm(const QByteArray& term);
     void addXattrPositionTerm(const QByteArray& term, int position = 0);
 
@@ -56,6 +71,18 @@ public:
     void setContentIndexing(bool val);
     bool contentIndexing() const;
 
+    /**
+     * The order of the content indexing, lower values are indexed first.
+     * Defaults to defaultContentIndexingPriority() of the mtime.
+     */
+    void setContentIndexingPriority(quint32 priority);
+    quint32 contentIndexingPriority() const;
+
+    /**
+     * Recently modified files are indexed first
+     */
+    static quint32 defaultContentIndexingPriority(quint32 mTime);
+
     void setMTime(quint32 val) { m_mTime = val; }
     void setCTime(quint32 val) { m_cTime = val; }
 
@@ -65,25 +92,34 @@ private:
     quint64 m_id = 0;
     quint64 m_parentId = 0;
 
-    struct TermData {
-        QVector<uint> positions;
-    };
-    QMap<QByteArray, TermData> m_terms;
-    QMap<QByteArray, TermData> m_xattrTerms;
-    QMap<QByteArray, TermData> m_fileNameTerms;
+    TermStore m_terms;
+    TermStore m_xattrTerms;
+    TermStore m_fileNameTerms;
 
     QByteArray m_url;
     bool m_contentIndexing = false;
+    quint32 m_contentIndexingPriority = 0; //< 0 if not set
 
     quint32 m_mTime = 0; //< modification time, seconds since Epoch
     quint32 m_cTime = 0; //< inode change time, seconds since Epoch
     QByteArray m_data;
 
     friend class WriteTransaction;
+    friend class BulkLoader;
     friend class TermGeneratorTest;
     friend class BasicIndexingJobTest;
+
+    friend BALOO_ENGINE_EXPORT QDataStream& operator<<(QDataStream& stream, const Document& doc);
+    friend BALOO_ENGINE_EXPORT QDataStream& operator>>(QDataStream& stream, Document& doc);
 };
 
+/**
+ * Serialization of all the document data, used to pass the documents
+ * from the extractor processes to baloo_file
+ */
+BALOO_ENGINE_EXPORT QDataStream& operator<<(QDataStream& stream, const Document& doc);
+BALOO_ENGINE_EXPORT QDataStream& operator>>(QDataStream& stream, Document& doc);
+
 inline QDebug operator<<(QDebug dbg, const Document &doc) {
     dbg << doc.id() << doc.url();
     return dbg;
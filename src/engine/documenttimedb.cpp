@@ -8,6 +8,8 @@
 #include "documenttimedb.h"
 #include "enginedebug.h"
 
+#include <algorithm>
+
 using namespace Baloo;
 
 DocumentTimeDB::DocumentTimeDB(MDB_dbi dbi, MDB_txn* txn)
@@ -84,6 +86,40 @@ DocumentTimeDB::TimeInfo DocumentTimeDB::get(quint64 docId)
     return *(static_cast<TimeInfo*>(val.mv_data));
 }
 
+QVector<DocumentTimeDB::TimeInfo> DocumentTimeDB::get(const QVector<quint64>& docIds)
+{
+    Q_ASSERT(std::is_sorted(docIds.cbegin(), docIds.cend()));
+
+    QVector<TimeInfo> infos(docIds.size());
+
+    MDB_cursor* cursor;
+    int rc = mdb_cursor_open(m_txn, m_dbi, &cursor);
+    if (rc) {
+        qCWarning(ENGINE) << "DocumentTimeDB::get" << mdb_strerror(rc);
+        return infos;
+    }
+
+    for (int i = 0; i < docIds.size(); i++) {
+        quint64 docId = docIds[i];
+        MDB_val key;
+        key.mv_size = sizeof(quint64);
+        key.mv_data = &docId;
+
+        MDB_val val{0, nullptr};
+        rc = mdb_cursor_get(cursor, &key, &val, MDB_SET_KEY);
+        if (rc) {
+            if (rc != MDB_NOTFOUND) {
+                qCDebug(ENGINE) << "DocumentTimeDB::get" << docId << mdb_strerror(rc);
+            }
+            continue;
+        }
+        infos[i] = *(static_cast<TimeInfo*>(val.mv_data));
+    }
+
+    mdb_cursor_close(cursor);
+    return infos;
+}
+
 void DocumentTimeDB::del(quint64 docId)
 {
     Q_ASSERT(docId > 0);
@@ -12,6 +12,8 @@
 
 #include <QMap>
 #include <QDebug>
+#include <QVector>
+
 #include <lmdb.h>
 
 namespace Baloo {
@@ -46,6 +48,13 @@ public:
     void put(quint64 docId, const TimeInfo& info);
     TimeInfo get(quint64 docId);
 
+    /**
+     * The times of the sorted \p docIds, a default TimeInfo for the ids
+     * without one. The ids are looked up with one cursor, which skips the
+     * descent from the root for ids on the page of the previous one.
+     */
+    QVector<TimeInfo> get(const QVector<quint64>& docIds);
+
     void del(quint64 docId);
     bool contains(quint64 docId);
 
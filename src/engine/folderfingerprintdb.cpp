@@ -0,0 +1,128 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "folderfingerprintdb.h"
+#include "enginedebug.h"
+
+#include <cstring>
+
+using namespace Baloo;
+
+namespace {
+MDB_dbi openDb(MDB_txn* txn, unsigned int flags)
+{
+    MDB_dbi dbi = 0;
+    int rc = mdb_dbi_open(txn, "folderfingerprintdb", flags, &dbi);
+    if (rc) {
+        if (rc != MDB_NOTFOUND || (flags & MDB_CREATE)) {
+            qCWarning(ENGINE) << "FolderFingerprintDB::open" << mdb_strerror(rc);
+        }
+        return 0;
+    }
+    return dbi;
+}
+}
+
+FolderFingerprintDB::FolderFingerprintDB(MDB_dbi dbi, MDB_txn* txn)
+    : m_txn(txn)
+    , m_dbi(dbi)
+{
+    Q_ASSERT(txn != nullptr);
+}
+
+FolderFingerprintDB::~FolderFingerprintDB()
+{
+}
+
+MDB_dbi FolderFingerprintDB::create(MDB_txn* txn)
+{
+    return openDb(txn, MDB_CREATE | MDB_INTEGERKEY);
+}
+
+MDB_dbi FolderFingerprintDB::open(MDB_txn* txn)
+{
+    return openDb(txn, MDB_INTEGERKEY);
+}
+
+void FolderFingerprintDB::put(quint64 folderId, const Fingerprint& fingerprint)
+{
+    Q_ASSERT(folderId > 0);
+
+    if (!m_dbi) {
+        return;
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&folderId)};
+    MDB_val val{sizeof(Fingerprint), static_cast<void*>(const_cast<Fingerprint*>(&fingerprint))};
+    int rc = mdb_put(m_txn, m_dbi, &key, &val, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "FolderFingerprintDB::put" << folderId << mdb_strerror(rc);
+    }
+}
+
+bool FolderFingerprintDB::get(quint64 folderId, Fingerprint& fingerprint) const
+{
+    Q_ASSERT(folderId > 0);
+
+    if (!m_dbi) {
+        return false;
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&folderId)};
+    MDB_val val{0, nullptr};
+    int rc = mdb_get(m_txn, m_dbi, &key, &val);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "FolderFingerprintDB::get" << folderId << mdb_strerror(rc);
+        }
+        return false;
+    }
+    if (val.mv_size != sizeof(Fingerprint)) {
+        return false;
+    }
+
+    memcpy(&fingerprint, val.mv_data, sizeof(Fingerprint));
+    return true;
+}
+
+void FolderFingerprintDB::del(quint64 folderId)
+{
+    Q_ASSERT(folderId > 0);
+
+    if (!m_dbi) {
+        return;
+    }
+
+    MDB_val key{sizeof(quint64), static_cast<void*>(&folderId)};
+    int rc = mdb_del(m_txn, m_dbi, &key, nullptr);
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "FolderFingerprintDB::del" << folderId << mdb_strerror(rc);
+    }
+}
+
+QMap<quint64, FolderFingerprintDB::Fingerprint> FolderFingerprintDB::toTestMap() const
+{
+    QMap<quint64, Fingerprint> map;
+    if (!m_dbi) {
+        return map;
+    }
+
+    MDB_cursor* cursor;
+    mdb_cursor_open(m_txn, m_dbi, &cursor);
+
+    MDB_val key{0, nullptr};
+    MDB_val val{0, nullptr};
+    while (mdb_cursor_get(cursor, &key, &val, MDB_NEXT) == 0) {
+        const quint64 id = *static_cast<quint64*>(key.mv_data);
+        Fingerprint fingerprint;
+        memcpy(&fingerprint, val.mv_data, sizeof(Fingerprint));
+        map.insert(id, fingerprint);
+    }
+
+    mdb_cursor_close(cursor);
+    return map;
+}
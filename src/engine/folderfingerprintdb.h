@@ -0,0 +1,73 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_FOLDERFINGERPRINTDB_H
+#define BALOO_FOLDERFINGERPRINTDB_H
+
+#include "engine_export.h"
+
+#include <QMap>
+#include <QDebug>
+
+#include <lmdb.h>
+
+namespace Baloo {
+
+/**
+ * Stores a fingerprint of the listing of a folder, its times and number
+ * of entries when the crawl last handed over all its entries. The check
+ * for unindexed files compares it with the folder on disk, and does not
+ * need to stat the files of an unchanged folder.
+ *
+ * The fingerprints are optional. Databases created before they existed
+ * do not have them when opened read-only, the dbi is 0 then and all
+ * lookups fail.
+ */
+class BALOO_ENGINE_EXPORT FolderFingerprintDB
+{
+public:
+    FolderFingerprintDB(MDB_dbi dbi, MDB_txn* txn);
+    ~FolderFingerprintDB();
+
+    static MDB_dbi create(MDB_txn* txn);
+    static MDB_dbi open(MDB_txn* txn);
+
+    struct Fingerprint
+    {
+        quint32 mTime = 0;
+        quint32 cTime = 0;
+        /** The number of directory entries, including the filtered ones */
+        quint32 entryCount = 0;
+
+        bool operator == (const Fingerprint& rhs) const {
+            return mTime == rhs.mTime && cTime == rhs.cTime && entryCount == rhs.entryCount;
+        }
+    };
+
+    void put(quint64 folderId, const Fingerprint& fingerprint);
+
+    /**
+     * Returns false if there is no fingerprint for \p folderId
+     */
+    bool get(quint64 folderId, Fingerprint& fingerprint) const;
+    void del(quint64 folderId);
+
+    QMap<quint64, Fingerprint> toTestMap() const;
+
+private:
+    MDB_txn* m_txn;
+    MDB_dbi m_dbi;
+};
+
+inline QDebug operator<<(QDebug dbg, const FolderFingerprintDB::Fingerprint& fingerprint) {
+    dbg << "(" << fingerprint.mTime << "," << fingerprint.cTime << "," << fingerprint.entryCount << ")";
+    return dbg;
+}
+
+}
+
+#endif // BALOO_FOLDERFINGERPRINTDB_H
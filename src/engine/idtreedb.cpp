@@ -72,6 +72,13 @@ void IdTreeDB::set(quint64 docId, const QVector<quint64> &subDocIds)
 }
 
 QVector<quint64> IdTreeDB::get(quint64 docId)
+{
+    QVector<quint64> list;
+    appendTo(docId, list);
+    return list;
+}
+
+void IdTreeDB::appendTo(quint64 docId, QVector<quint64>& list)
 {
     MDB_val key;
     key.mv_size = sizeof(quint64);
@@ -83,14 +90,13 @@ QVector<quint64> IdTreeDB::get(quint64 docId)
         if (rc != MDB_NOTFOUND) {
             qCDebug(ENGINE) << "IdTreeDB::get" << docId << mdb_strerror(rc);
         }
-        return QVector<quint64>();
+        return;
     }
 
-    // FIXME: This still makes a copy of the data. Perhaps we can avoid that?
-    QVector<quint64> list(val.mv_size / sizeof(quint64));
-    memcpy(list.data(), val.mv_data, val.mv_size);
-
-    return list;
+    // The values are not necessarily 8 byte aligned, copy instead of casting
+    const int offset = list.size();
+    list.resize(offset + val.mv_size / sizeof(quint64));
+    memcpy(list.data() + offset, val.mv_data, val.mv_size);
 }
 
 //
@@ -116,7 +122,7 @@ public:
         if (m_resultList.isEmpty()) {
             while (!m_idList.isEmpty()) {
                 quint64 id = m_idList.takeLast();
-                m_idList << m_db.get(id);
+                m_db.appendTo(id, m_idList);
                 m_resultList << id;
             }
             std::sort(m_resultList.begin(), m_resultList.end());
@@ -137,6 +143,34 @@ public:
         }
     }
 
+    quint64 estimatedSize() const override {
+        // The number of ids is only known after walking the tree
+        return m_resultList.isEmpty() ? PostingIterator::estimatedSize() : m_resultList.size();
+    }
+
+    quint64 skipTo(quint64 id) override {
+        quint64 currentId = docId();
+        if (currentId >= id) {
+            return currentId;
+        }
+
+        if (m_resultList.isEmpty()) {
+            // Collect and sort the ids first
+            currentId = next();
+            if (currentId == 0 || currentId >= id) {
+                return currentId;
+            }
+        }
+        if (m_pos >= m_resultList.size()) {
+            return 0;
+        }
+
+        const auto begin = m_resultList.cbegin();
+        const auto it = gallopingLowerBound(begin + m_pos, m_resultList.cend(), id);
+        m_pos = it - begin;
+        return it == m_resultList.cend() ? 0 : *it;
+    }
+
 private:
     IdTreeDB m_db;
     int m_pos;
@@ -28,6 +28,12 @@ public:
     void set(quint64 docId, const QVector<quint64> &subDocIds);
     QVector<quint64> get(quint64 docId);
 
+    /**
+     * Appends the sub document ids of \p docId to \p list. Unlike get(),
+     * this copies the ids straight from the database pages into \p list.
+     */
+    void appendTo(quint64 docId, QVector<quint64>& list);
+
     /**
      * Returns an iterator which will return all the docIds which use \p docId
      * are the parent docID.
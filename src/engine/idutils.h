@@ -43,6 +43,14 @@ inline quint64 statBufToId(const QT_STATBUF& stBuf)
 }
 
 #ifndef Q_OS_WIN
+/**
+ * Folds the filesystem id into the 32 bits kept by statBufToId()
+ */
+inline quint32 foldFsid(quint64 fsid)
+{
+    return static_cast<quint32>(fsid ^ (fsid >> 32));
+}
+
 inline int statWithFsid(const char* path, QT_STATBUF* statBuf)
 {
     int ret = QT_LSTAT(path, statBuf);
@@ -53,8 +61,7 @@ inline int statWithFsid(const char* path, QT_STATBUF* statBuf)
     struct statvfs fsBuf;
     ret = statvfs(path, &fsBuf);
     if (ret == 0 && fsBuf.f_fsid != 0) {
-        // Fold FSID into 32 bits, statBufToId would discard anything else
-        statBuf->st_dev = static_cast<quint32>(fsBuf.f_fsid ^ (fsBuf.f_fsid >> 32));
+        statBuf->st_dev = foldFsid(fsBuf.f_fsid);
     }
     return ret;
 }
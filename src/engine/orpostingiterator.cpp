@@ -7,12 +7,22 @@
 
 #include "orpostingiterator.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Baloo;
 
+namespace {
+// Orders the heap by the smallest docId
+bool heapCompare(const PostingIterator* lhs, const PostingIterator* rhs)
+{
+    return lhs->docId() > rhs->docId();
+}
+}
+
 OrPostingIterator::OrPostingIterator(const QVector<PostingIterator*>& iterators)
     : m_iterators(iterators)
     , m_docId(0)
-    , m_nextId(0)
 {
     /*
      * Check for null iterators
@@ -20,13 +30,15 @@ OrPostingIterator::OrPostingIterator(const QVector<PostingIterator*>& iterators)
      */
     m_iterators.removeAll(nullptr);
 
-    for (PostingIterator* iter : std::as_const(m_iterators)) {
-        auto docId = iter->next();
-        // find smallest docId
-        if (docId && (docId < m_nextId || m_nextId == 0)) {
-            m_nextId = docId;
+    for (PostingIterator*& iter : m_iterators) {
+        if (!iter->next()) {
+            delete iter;
+            iter = nullptr;
         }
     }
+    m_iterators.removeAll(nullptr);
+
+    std::make_heap(m_iterators.begin(), m_iterators.end(), heapCompare);
 }
 
 OrPostingIterator::~OrPostingIterator()
@@ -39,68 +51,88 @@ quint64 OrPostingIterator::docId() const
     return m_docId;
 }
 
-quint64 OrPostingIterator::skipTo(quint64 id)
+void OrPostingIterator::siftDown(int pos)
 {
-    if (m_docId >= id) {
-        return m_docId;
-    }
-    if (m_nextId == 0) {
-        m_docId = m_nextId;
-        return 0;
-    }
+    const int size = m_iterators.size();
+    PostingIterator* iter = m_iterators[pos];
+    const quint64 docId = iter->docId();
 
-    if (id > m_nextId) {
-        // Fast forward - move all iterators to the lowest position
-        // greater or equal to id
-        m_nextId = 0;
-        for (PostingIterator* iter : std::as_const(m_iterators)) {
-            auto docId = iter->skipTo(id);
-            if (docId > 0) {
-                if (docId < m_nextId || !m_nextId) {
-                    m_nextId = docId;
-                }
-            }
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && m_iterators[child + 1]->docId() < m_iterators[child]->docId()) {
+            child++;
         }
-        if (m_nextId == 0) {
-            m_docId = m_nextId;
-            return 0;
+        if (m_iterators[child]->docId() >= docId) {
+            break;
         }
+        m_iterators[pos] = m_iterators[child];
+        pos = child;
     }
+    m_iterators[pos] = iter;
+}
 
-    m_docId = m_nextId;
-    m_nextId = 0;
+void OrPostingIterator::popTop()
+{
+    delete m_iterators[0];
+    m_iterators[0] = m_iterators.last();
+    m_iterators.removeLast();
+    if (!m_iterators.isEmpty()) {
+        siftDown(0);
+    }
+}
 
-    // advance all iterators which point to the lowest docId
-    for (PostingIterator*& iter : m_iterators) {
-        auto docId = iter->docId();
-        if (docId == m_docId) {
-            docId = iter->next();
+quint64 OrPostingIterator::estimatedSize() const
+{
+    // Upper bound, ignoring overlaps between the sub iterators
+    quint64 size = 0;
+    for (const PostingIterator* iter : m_iterators) {
+        const quint64 subSize = iter->estimatedSize();
+        if (subSize > std::numeric_limits<quint64>::max() - size) {
+            return std::numeric_limits<quint64>::max();
         }
+        size += subSize;
+    }
+    return size;
+}
 
-        if (docId == 0) {
-            // remove element if iterator has reached the end
-            delete iter;
-            iter = nullptr;
+quint64 OrPostingIterator::skipTo(quint64 id)
+{
+    if (m_docId >= id) {
+        return m_docId;
+    }
+
+    // Move all iterators behind id forward, starting with the lowest one
+    while (!m_iterators.isEmpty() && m_iterators.first()->docId() < id) {
+        if (m_iterators.first()->skipTo(id)) {
+            siftDown(0);
         } else {
-            // check if the docId is the new lowest docId
-            if (docId < m_nextId || !m_nextId) {
-                m_nextId = docId;
-            }
+            popTop();
         }
     }
-    auto tail = std::remove_if(m_iterators.begin(), m_iterators.end(),
-        [](const PostingIterator* it) { return it == nullptr; });
-    m_iterators.erase(tail, m_iterators.end());
 
-    return m_docId;
+    return next();
 }
 
 quint64 OrPostingIterator::next()
 {
-    if (m_nextId) {
-        m_docId = skipTo(m_nextId);
-    } else {
+    if (m_iterators.isEmpty()) {
         m_docId = 0;
+        return 0;
+    }
+
+    m_docId = m_iterators.first()->docId();
+
+    // advance all iterators which point to the lowest docId
+    while (!m_iterators.isEmpty() && m_iterators.first()->docId() == m_docId) {
+        if (m_iterators.first()->next()) {
+            siftDown(0);
+        } else {
+            popTop();
+        }
     }
+
     return m_docId;
 }
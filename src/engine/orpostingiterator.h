@@ -13,6 +13,12 @@
 
 namespace Baloo {
 
+/**
+ * Returns the union of the docIds of all its sub iterators.
+ *
+ * The sub iterators are kept in a min-heap ordered by their current docId,
+ * so advancing the iterator costs O(log n) in the number of sub iterators.
+ */
 class BALOO_ENGINE_EXPORT OrPostingIterator : public PostingIterator
 {
 public:
@@ -22,11 +28,18 @@ public:
     quint64 next() override;
     quint64 docId() const override;
     quint64 skipTo(quint64 docId) override;
+    quint64 estimatedSize() const override;
 
 private:
+    BALOO_ENGINE_NO_EXPORT void siftDown(int pos);
+    BALOO_ENGINE_NO_EXPORT void popTop();
+
+    /*
+     * Min-heap of the sub iterators. Each is positioned on the
+     * next docId it will contribute, which is larger than m_docId.
+     */
     QVector<PostingIterator*> m_iterators;
     quint64 m_docId;
-    quint64 m_nextId;
 };
 }
 
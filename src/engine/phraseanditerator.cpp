@@ -8,16 +8,33 @@
 #include "phraseanditerator.h"
 #include "positioninfo.h"
 
+#include <algorithm>
+#include <numeric>
+
 using namespace Baloo;
 
-PhraseAndIterator::PhraseAndIterator(const QVector<VectorPositionInfoIterator*>& iterators)
+PhraseAndIterator::PhraseAndIterator(const QVector<PositionInfoIterator*>& iterators)
     : m_iterators(iterators)
     , m_docId(0)
 {
-    if (m_iterators.contains(nullptr)) {
+    QVector<quint64> sizes;
+    sizes.reserve(m_iterators.size());
+    for (const PositionInfoIterator* iter : std::as_const(m_iterators)) {
+        sizes << (iter ? iter->estimatedSize() : 0);
+    }
+
+    // An empty sub iterator makes the whole phrase empty
+    if (sizes.contains(0)) {
         qDeleteAll(m_iterators);
         m_iterators.clear();
+        return;
     }
+
+    m_skipOrder.resize(m_iterators.size());
+    std::iota(m_skipOrder.begin(), m_skipOrder.end(), 0);
+    std::stable_sort(m_skipOrder.begin(), m_skipOrder.end(), [&sizes](int lhs, int rhs) {
+        return sizes[lhs] < sizes[rhs];
+    });
 }
 
 PhraseAndIterator::~PhraseAndIterator()
@@ -74,6 +91,11 @@ bool PhraseAndIterator::checkIfPositionsMatch()
     return false;
 }
 
+quint64 PhraseAndIterator::estimatedSize() const
+{
+    return m_iterators.isEmpty() ? 0 : m_iterators[m_skipOrder[0]]->estimatedSize();
+}
+
 quint64 PhraseAndIterator::skipTo(quint64 id)
 {
     if (m_iterators.isEmpty()) {
@@ -83,8 +105,8 @@ quint64 PhraseAndIterator::skipTo(quint64 id)
 
     while (true) {
         quint64 lower_bound = id;
-        for (PostingIterator* iter : std::as_const(m_iterators)) {
-            lower_bound = iter->skipTo(lower_bound);
+        for (int i : std::as_const(m_skipOrder)) {
+            lower_bound = m_iterators[i]->skipTo(lower_bound);
 
             if (lower_bound == 0) {
                 m_docId = 0;
@@ -97,7 +119,7 @@ quint64 PhraseAndIterator::skipTo(quint64 id)
                 m_docId = lower_bound;
                 return lower_bound;
             } else {
-                lower_bound = m_iterators[0]->next();
+                lower_bound = m_iterators[m_skipOrder[0]]->next();
             }
         }
         id = lower_bound;
@@ -111,7 +133,7 @@ quint64 PhraseAndIterator::next()
         return 0;
     }
 
-    m_docId = m_iterators[0]->next();
+    m_docId = m_iterators[m_skipOrder[0]]->next();
     m_docId = skipTo(m_docId);
 
     return m_docId;
@@ -8,8 +8,7 @@
 #ifndef BALOO_PHRASEANDITERATOR_H
 #define BALOO_PHRASEANDITERATOR_H
 
-#include "postingiterator.h"
-#include "vectorpositioninfoiterator.h"
+#include "positioninfoiterator.h"
 
 #include <QVector>
 
@@ -18,15 +17,21 @@ namespace Baloo {
 class BALOO_ENGINE_EXPORT PhraseAndIterator : public PostingIterator
 {
 public:
-    explicit PhraseAndIterator(const QVector<VectorPositionInfoIterator*>& iterators);
+    explicit PhraseAndIterator(const QVector<PositionInfoIterator*>& iterators);
     ~PhraseAndIterator();
 
     quint64 next() override;
     quint64 docId() const override;
     quint64 skipTo(quint64 docId) override;
+    quint64 estimatedSize() const override;
 
 private:
-    QVector<VectorPositionInfoIterator*> m_iterators;
+    QVector<PositionInfoIterator*> m_iterators;
+    /*
+     * Indices into m_iterators, rarest first. m_iterators itself has to stay
+     * in phrase order for matching the positions.
+     */
+    QVector<int> m_skipOrder;
     quint64 m_docId;
 
     BALOO_ENGINE_NO_EXPORT bool checkIfPositionsMatch();
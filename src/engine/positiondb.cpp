@@ -9,14 +9,16 @@
 #include "positiondb.h"
 #include "positioncodec.h"
 #include "positioninfo.h"
-#include "postingiterator.h"
-#include "vectorpositioninfoiterator.h"
+#include "positioninfoiterator.h"
+
+#include <algorithm>
 
 using namespace Baloo;
 
 PositionDB::PositionDB(MDB_dbi dbi, MDB_txn* txn)
     : m_txn(txn)
     , m_dbi(dbi)
+    , m_chunkDb(dbi, txn)
 {
     Q_ASSERT(txn != nullptr);
     Q_ASSERT(dbi != 0);
@@ -55,19 +57,12 @@ void PositionDB::put(const QByteArray& term, const QVector<PositionInfo>& list)
     Q_ASSERT(!term.isEmpty());
     Q_ASSERT(!list.isEmpty());
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
-
-    QByteArray data = PositionCodec::encode(list);
-
-    MDB_val val;
-    val.mv_size = data.size();
-    val.mv_data = static_cast<void*>(data.data());
+    m_chunkDb.delAll(term);
 
-    int rc = mdb_put(m_txn, m_dbi, &key, &val, 0);
-    if (rc) {
-        qCWarning(ENGINE) << "PositionDB::put" << mdb_strerror(rc);
+    // The whole list is known, so the chunks are filled completely
+    for (int i = 0; i < list.size(); i += ChunkSize) {
+        const QVector<PositionInfo> chunk = list.mid(i, ChunkSize);
+        m_chunkDb.put(term, i == 0 ? 0 : chunk.first().docId, PositionCodec::encode(chunk));
     }
 }
 
@@ -75,35 +70,83 @@ QVector<PositionInfo> PositionDB::get(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+    QVector<PositionInfo> list;
+    const auto chunks = m_chunkDb.chunks(term);
+    for (const TermChunkDB::Chunk& chunk : chunks) {
+        list += PositionCodec::decode(QByteArray::fromRawData(static_cast<char*>(chunk.data.mv_data), chunk.data.mv_size));
+    }
+    return list;
+}
+
+QVector<uint> PositionDB::positions(const QByteArray& term, quint64 docId)
+{
+    Q_ASSERT(!term.isEmpty());
 
-    MDB_val val{0, nullptr};
-    int rc = mdb_get(m_txn, m_dbi, &key, &val);
-    if (rc) {
-        if (rc != MDB_NOTFOUND) {
-            qCDebug(ENGINE) << "PositionDB::get" << term << mdb_strerror(rc);
+    // Like DBPositionInfoIterator, only the positions of docId are decoded
+    const TermChunkDB::Chunk chunk = m_chunkDb.chunkContaining(term, docId);
+    PositionListReader reader(static_cast<const char*>(chunk.data.mv_data), chunk.data.mv_size);
+    while (quint64 id = reader.next()) {
+        if (id == docId) {
+            return reader.positions();
+        }
+        if (id > docId) {
+            break;
         }
-        return QVector<PositionInfo>();
     }
+    return QVector<uint>();
+}
+
+void PositionDB::del(const QByteArray& term)
+{
+    Q_ASSERT(!term.isEmpty());
+
+    m_chunkDb.delAll(term);
+}
 
-    QByteArray data = QByteArray::fromRawData(static_cast<char*>(val.mv_data), val.mv_size);
+QVector<quint64> PositionDB::chunks(const QByteArray& term)
+{
+    Q_ASSERT(!term.isEmpty());
+
+    return m_chunkDb.chunkStarts(term);
+}
+
+QVector<PositionInfo> PositionDB::getChunk(const QByteArray& term, quint64 chunkStart)
+{
+    Q_ASSERT(!term.isEmpty());
 
+    const QByteArray data = m_chunkDb.get(term, chunkStart);
+    if (data.isEmpty()) {
+        return QVector<PositionInfo>();
+    }
     return PositionCodec::decode(data);
 }
 
-void PositionDB::del(const QByteArray& term)
+void PositionDB::putChunk(const QByteArray& term, quint64 chunkStart, const QVector<PositionInfo>& list)
 {
     Q_ASSERT(!term.isEmpty());
+    Q_ASSERT(list.isEmpty() || list.first().docId >= chunkStart);
+
+    QVector<PositionInfo> merged = list;
+    if (list.size() < MinChunkSize) {
+        const TermChunkDB::Chunk next = m_chunkDb.nextChunk(term, chunkStart);
+        if (next.data.mv_size) {
+            merged += PositionCodec::decode(QByteArray::fromRawData(static_cast<char*>(next.data.mv_data), next.data.mv_size));
+            m_chunkDb.del(term, next.start);
+        }
+    }
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+    if (merged.isEmpty()) {
+        m_chunkDb.del(term, chunkStart);
+        return;
+    }
 
-    int rc = mdb_del(m_txn, m_dbi, &key, nullptr);
-    if (rc != 0 && rc != MDB_NOTFOUND) {
-        qCDebug(ENGINE) << "PositionDB::del" << term << mdb_strerror(rc);
+    // Split like PostingDB::putChunk()
+    const int count = (merged.size() + ChunkSize - 1) / ChunkSize;
+    for (int n = 0; n < count; n++) {
+        const int from = merged.size() * n / count;
+        const int to = merged.size() * (n + 1) / count;
+        const QVector<PositionInfo> chunk = merged.mid(from, to - from);
+        m_chunkDb.put(term, n == 0 ? chunkStart : chunk.first().docId, PositionCodec::encode(chunk));
     }
 }
 
@@ -111,23 +154,80 @@ void PositionDB::del(const QByteArray& term)
 // Query
 //
 
-VectorPositionInfoIterator* PositionDB::iter(const QByteArray& term)
+class DBPositionInfoIterator : public PositionInfoIterator {
+public:
+    explicit DBPositionInfoIterator(const QVector<TermChunkDB::Chunk>& chunks)
+        : m_chunks(chunks)
+        , m_reader(nullptr, 0)
+    {
+        for (const TermChunkDB::Chunk& chunk : chunks) {
+            m_dataSize += chunk.data.mv_size;
+        }
+        setChunk(0);
+    }
+
+    quint64 estimatedSize() const override {
+        // Each entry takes at least 10 bytes: docId, positions count and one position
+        return (m_dataSize + 9) / 10;
+    }
+
+    quint64 docId() const override {
+        return m_reader.docId();
+    }
+
+    quint64 next() override {
+        m_positionsDecoded = false;
+        m_positions.clear();
+
+        while (m_chunk < m_chunks.size()) {
+            if (quint64 id = m_reader.next()) {
+                return id;
+            }
+            setChunk(m_chunk + 1);
+        }
+        return 0;
+    }
+
+    QVector<uint> positions() override {
+        // PhraseAndIterator queries the positions repeatedly, decode only once
+        if (!m_positionsDecoded) {
+            m_positions = m_reader.positions();
+            m_positionsDecoded = true;
+        }
+        return m_positions;
+    }
+
+private:
+    void setChunk(int chunk) {
+        m_chunk = chunk;
+        if (chunk < m_chunks.size()) {
+            const MDB_val& data = m_chunks[chunk].data;
+            m_reader = PositionListReader(static_cast<const char*>(data.mv_data), data.mv_size);
+        } else {
+            m_reader = PositionListReader(nullptr, 0);
+        }
+    }
+
+    const QVector<TermChunkDB::Chunk> m_chunks;
+    int m_chunk = 0;
+    quint64 m_dataSize = 0;
+
+    PositionListReader m_reader;
+    QVector<uint> m_positions;
+    bool m_positionsDecoded = false;
+};
+
+PositionInfoIterator* PositionDB::iter(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
-
-    MDB_val val{0, nullptr};
-    int rc = mdb_get(m_txn, m_dbi, &key, &val);
-    if (rc) {
-        qCDebug(ENGINE) << "PositionDB::iter" << term << mdb_strerror(rc);
+    const auto chunks = m_chunkDb.chunks(term);
+    if (chunks.isEmpty()) {
+        qCDebug(ENGINE) << "PositionDB::iter" << term << "not found";
         return nullptr;
     }
 
-    QByteArray ba(static_cast<char*>(val.mv_data), val.mv_size);
-    return new VectorPositionInfoIterator(PositionCodec::decode(ba));
+    return new DBPositionInfoIterator(chunks);
 }
 
 QMap<QByteArray, QVector<PositionInfo>> PositionDB::toTestMap() const
@@ -149,10 +249,10 @@ QMap<QByteArray, QVector<PositionInfo>> PositionDB::toTestMap() const
             break;
         }
 
-        const QByteArray ba(static_cast<char*>(key.mv_data), key.mv_size);
+        const QByteArray ba(static_cast<char*>(key.mv_data), TermChunkDB::termSize(key));
         const QByteArray data(static_cast<char*>(val.mv_data), val.mv_size);
         const QVector<PositionInfo> vinfo = PositionCodec().decode(data);
-        map.insert(ba, vinfo);
+        map[ba] += vinfo;
     }
 
     mdb_cursor_close(cursor);
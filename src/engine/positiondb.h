@@ -9,6 +9,7 @@
 #define BALOO_POSITIONDB_H
 
 #include "engine_export.h"
+#include "termchunkdb.h"
 
 #include <QByteArray>
 #include <QMap>
@@ -18,8 +19,15 @@
 namespace Baloo {
 
 class PositionInfo;
-class VectorPositionInfoIterator;
+class PositionInfoIterator;
 
+/**
+ * The PositionDB maps <term> -> <id1, positions> <id2, positions> ...
+ * It is used for phrase queries.
+ *
+ * Like in the PostingDB, large lists are split into chunks of at most
+ * ChunkSize entries, each stored under its own key (see TermChunkDB).
+ */
 class BALOO_ENGINE_EXPORT PositionDB
 {
 public:
@@ -29,16 +37,45 @@ public:
     static MDB_dbi create(MDB_txn* txn);
     static MDB_dbi open(MDB_txn* txn);
 
+    static constexpr int ChunkSize = 1024;
+    /// Smaller chunks are merged with the following chunk when written
+    static constexpr int MinChunkSize = ChunkSize / 4;
+
     void put(const QByteArray& term, const QVector<PositionInfo>& list);
     QVector<PositionInfo> get(const QByteArray& term);
+
+    /**
+     * The positions of \p term in the document \p docId
+     */
+    QVector<uint> positions(const QByteArray& term, quint64 docId);
     void del(const QByteArray& term);
 
-    VectorPositionInfoIterator* iter(const QByteArray& term);
+    /**
+     * Returns the start ids of the chunks of \p term, see PostingDB::chunks()
+     */
+    QVector<quint64> chunks(const QByteArray& term);
+    QVector<PositionInfo> getChunk(const QByteArray& term, quint64 chunkStart);
+
+    /**
+     * Replaces the chunk starting at \p chunkStart. A \p list exceeding
+     * ChunkSize is split into equally sized chunks. A \p list below
+     * MinChunkSize is merged with the following chunk, an empty \p list
+     * without a following chunk removes the chunk.
+     */
+    void putChunk(const QByteArray& term, quint64 chunkStart, const QVector<PositionInfo>& list);
+
+    /**
+     * The returned iterator reads the positions directly from the database
+     * pages. It must not be used after the transaction has been finished,
+     * or after the term has been modified.
+     */
+    PositionInfoIterator* iter(const QByteArray& term);
 
     QMap<QByteArray, QVector<PositionInfo>> toTestMap() const;
 private:
     MDB_txn* m_txn;
     MDB_dbi m_dbi;
+    TermChunkDB m_chunkDb;
 };
 
 }
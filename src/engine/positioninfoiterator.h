@@ -0,0 +1,26 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2015 Vishesh Handa <vhanda@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_POSITIONINFOITERATOR_H
+#define BALOO_POSITIONINFOITERATOR_H
+
+#include "postingiterator.h"
+
+namespace Baloo {
+
+/**
+ * A PostingIterator which additionally provides the positions of
+ * the term in the current document.
+ */
+class BALOO_ENGINE_EXPORT PositionInfoIterator : public PostingIterator
+{
+public:
+    virtual QVector<uint> positions() = 0;
+};
+}
+
+#endif // BALOO_POSITIONINFOITERATOR_H
@@ -8,13 +8,17 @@
 #include "enginedebug.h"
 #include "postingdb.h"
 #include "orpostingiterator.h"
+#include "vectorpostingiterator.h"
 #include "postingcodec.h"
 
+#include <algorithm>
+
 using namespace Baloo;
 
 PostingDB::PostingDB(MDB_dbi dbi, MDB_txn* txn)
     : m_txn(txn)
     , m_dbi(dbi)
+    , m_chunkDb(dbi, txn)
 {
     Q_ASSERT(txn != nullptr);
     Q_ASSERT(dbi != 0);
@@ -53,55 +57,79 @@ void PostingDB::put(const QByteArray& term, const PostingList& list)
     Q_ASSERT(!term.isEmpty());
     Q_ASSERT(!list.isEmpty());
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+    m_chunkDb.delAll(term);
 
-    QByteArray arr = PostingCodec::encode(list);
+    // The whole list is known, so the chunks are filled completely
+    for (int i = 0; i < list.size(); i += ChunkSize) {
+        const PostingList chunk = list.mid(i, ChunkSize);
+        m_chunkDb.put(term, i == 0 ? 0 : chunk.first(), PostingCodec::encode(chunk));
+    }
+}
 
-    MDB_val val;
-    val.mv_size = arr.size();
-    val.mv_data = static_cast<void*>(arr.data());
+PostingList PostingDB::get(const QByteArray& term)
+{
+    Q_ASSERT(!term.isEmpty());
 
-    int rc = mdb_put(m_txn, m_dbi, &key, &val, 0);
-    if (rc) {
-        qCWarning(ENGINE) << "PostingDB::put" << mdb_strerror(rc);
+    PostingList list;
+    const auto chunks = m_chunkDb.chunks(term);
+    for (const TermChunkDB::Chunk& chunk : chunks) {
+        list += PostingCodec::decode(QByteArray::fromRawData(static_cast<char*>(chunk.data.mv_data), chunk.data.mv_size));
     }
+    return list;
 }
 
-PostingList PostingDB::get(const QByteArray& term)
+void PostingDB::del(const QByteArray& term)
 {
     Q_ASSERT(!term.isEmpty());
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+    m_chunkDb.delAll(term);
+}
 
-    MDB_val val{0, nullptr};
-    int rc = mdb_get(m_txn, m_dbi, &key, &val);
-    if (rc) {
-        if (rc != MDB_NOTFOUND) {
-            qCDebug(ENGINE) << "PostingDB::get" << term << mdb_strerror(rc);
-        }
-        return PostingList();
-    }
+QVector<quint64> PostingDB::chunks(const QByteArray& term)
+{
+    Q_ASSERT(!term.isEmpty());
+
+    return m_chunkDb.chunkStarts(term);
+}
 
-    QByteArray arr = QByteArray::fromRawData(static_cast<char*>(val.mv_data), val.mv_size);
+PostingList PostingDB::getChunk(const QByteArray& term, quint64 chunkStart)
+{
+    Q_ASSERT(!term.isEmpty());
 
+    const QByteArray arr = m_chunkDb.get(term, chunkStart);
+    if (arr.isEmpty()) {
+        return PostingList();
+    }
     return PostingCodec::decode(arr);
 }
 
-void PostingDB::del(const QByteArray& term)
+void PostingDB::putChunk(const QByteArray& term, quint64 chunkStart, const PostingList& list)
 {
     Q_ASSERT(!term.isEmpty());
+    Q_ASSERT(list.isEmpty() || list.first() >= chunkStart);
+
+    PostingList merged = list;
+    if (list.size() < MinChunkSize) {
+        const TermChunkDB::Chunk next = m_chunkDb.nextChunk(term, chunkStart);
+        if (next.data.mv_size) {
+            merged += PostingCodec::decode(QByteArray::fromRawData(static_cast<char*>(next.data.mv_data), next.data.mv_size));
+            m_chunkDb.del(term, next.start);
+        }
+    }
 
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+    if (merged.isEmpty()) {
+        m_chunkDb.del(term, chunkStart);
+        return;
+    }
 
-    int rc = mdb_del(m_txn, m_dbi, &key, nullptr);
-    if (rc != 0 && rc != MDB_NOTFOUND) {
-        qCDebug(ENGINE) << "PostingDB::del" << term << mdb_strerror(rc);
+    // The ids are spread over the whole id range, so an overflowing chunk is
+    // split into equally sized ones, each with room for further inserts
+    const int count = (merged.size() + ChunkSize - 1) / ChunkSize;
+    for (int n = 0; n < count; n++) {
+        const int from = merged.size() * n / count;
+        const int to = merged.size() * (n + 1) / count;
+        const PostingList chunk = merged.mid(from, to - from);
+        m_chunkDb.put(term, n == 0 ? chunkStart : chunk.first(), PostingCodec::encode(chunk));
     }
 }
 
@@ -125,7 +153,10 @@ QVector< QByteArray > PostingDB::fetchTermsStartingWith(const QByteArray& term)
         if (!arr.startsWith(term)) {
             break;
         }
-        terms << arr;
+        // Skip the chunks following the first one
+        if (TermChunkDB::termSize(key) == arr.size()) {
+            terms << arr;
+        }
         rc = mdb_cursor_get(cursor, &key, nullptr, MDB_NEXT);
     }
     if (rc != MDB_NOTFOUND) {
@@ -136,60 +167,149 @@ QVector< QByteArray > PostingDB::fetchTermsStartingWith(const QByteArray& term)
     return terms;
 }
 
+/*
+ * Iterates over the chunks of an encoded posting list, decoding one block
+ * at a time. skipTo() uses the chunk start ids and the block directories to
+ * jump over chunks and blocks which can not contain the requested id,
+ * without decoding them.
+ *
+ * The list is read in place from the database pages, which stay valid
+ * for the lifetime of the transaction.
+ */
 class DBPostingIterator : public PostingIterator {
 public:
-    DBPostingIterator(void* data, uint size);
+    explicit DBPostingIterator(const QVector<TermChunkDB::Chunk>& chunks);
     quint64 docId() const override;
     quint64 next() override;
+    quint64 skipTo(quint64 id) override;
+    quint64 estimatedSize() const override;
 
 private:
-    const QVector<quint64> m_vec;
+    void setChunk(int chunk);
+    bool loadBlock(int block);
+
+    const QVector<TermChunkDB::Chunk> m_chunks;
+    quint64 m_size;
+
+    int m_chunk;
+    PostingBlockReader m_reader;
+
+    quint64 m_ids[PostingCodec::BlockSize];
+    int m_block;
+    int m_blockLen;
     int m_pos;
 };
 
 PostingIterator* PostingDB::iter(const QByteArray& term)
 {
-    MDB_val key;
-    key.mv_size = term.size();
-    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
-
-    MDB_val val;
-    int rc = mdb_get(m_txn, m_dbi, &key, &val);
-    if (rc) {
-        qCDebug(ENGINE) << "PostingDB::iter" << term << mdb_strerror(rc);
+    const auto chunks = m_chunkDb.chunks(term);
+    if (chunks.isEmpty()) {
+        qCDebug(ENGINE) << "PostingDB::iter" << term << "not found";
         return nullptr;
     }
 
-    return new DBPostingIterator(val.mv_data, val.mv_size);
+    return new DBPostingIterator(chunks);
 }
 
 //
 // Posting Iterator
 //
-DBPostingIterator::DBPostingIterator(void* data, uint size)
-    : m_vec(PostingCodec().decode(QByteArray(static_cast<char*>(data), size)))
+DBPostingIterator::DBPostingIterator(const QVector<TermChunkDB::Chunk>& chunks)
+    : m_chunks(chunks)
+    , m_size(0)
+    , m_chunk(0)
+    , m_reader(nullptr, 0)
+    , m_block(-1)
+    , m_blockLen(0)
     , m_pos(-1)
 {
+    for (const TermChunkDB::Chunk& chunk : chunks) {
+        m_size += PostingBlockReader(static_cast<const char*>(chunk.data.mv_data), chunk.data.mv_size).size();
+    }
+    setChunk(0);
+}
+
+void DBPostingIterator::setChunk(int chunk)
+{
+    m_chunk = chunk;
+    m_block = -1;
+    m_blockLen = 0;
+    if (chunk < m_chunks.size()) {
+        const MDB_val& data = m_chunks[chunk].data;
+        m_reader = PostingBlockReader(static_cast<const char*>(data.mv_data), data.mv_size);
+    }
+}
+
+bool DBPostingIterator::loadBlock(int block)
+{
+    m_pos = 0;
+    while (m_chunk < m_chunks.size()) {
+        m_blockLen = block < m_reader.blockCount() ? m_reader.decodeBlock(block, m_ids) : 0;
+        if (m_blockLen > 0) {
+            m_block = block;
+            return true;
+        }
+
+        // Reached the end of the chunk, or the data is corrupt
+        setChunk(m_chunk + 1);
+        block = 0;
+    }
+    return false;
 }
 
 quint64 DBPostingIterator::docId() const
 {
-    if (m_pos < 0 || m_pos >= m_vec.size()) {
+    if (m_pos < 0 || m_pos >= m_blockLen) {
         return 0;
     }
 
-    return m_vec[m_pos];
+    return m_ids[m_pos];
 }
 
 quint64 DBPostingIterator::next()
 {
-    if (m_pos >= m_vec.size() - 1) {
-        m_pos = m_vec.size();
+    if (m_pos < m_blockLen - 1) {
+        m_pos++;
+        return m_ids[m_pos];
+    }
+
+    if (m_chunk >= m_chunks.size() || !loadBlock(m_block + 1)) {
         return 0;
     }
+    return m_ids[m_pos];
+}
+
+quint64 DBPostingIterator::estimatedSize() const
+{
+    return m_size;
+}
+
+quint64 DBPostingIterator::skipTo(quint64 id)
+{
+    const quint64 currentId = docId();
+    if (currentId >= id) {
+        return currentId;
+    }
+
+    while (m_chunk < m_chunks.size()) {
+        if (m_blockLen > 0 && m_ids[m_blockLen - 1] >= id) {
+            m_pos = gallopingLowerBound(m_ids + std::max(m_pos, 0), m_ids + m_blockLen, id) - m_ids;
+            return m_ids[m_pos];
+        }
 
-    m_pos++;
-    return m_vec[m_pos];
+        // The requested id is not in the current block, find the last chunk starting at or before it
+        auto it = std::upper_bound(m_chunks.cbegin() + m_chunk + 1, m_chunks.cend(), id,
+                                   [](quint64 id, const TermChunkDB::Chunk& chunk) { return id < chunk.start; });
+        const int chunk = (it - m_chunks.cbegin()) - 1;
+        if (chunk != m_chunk) {
+            setChunk(chunk);
+        }
+
+        if (!loadBlock(m_reader.findBlock(id, m_block + 1))) {
+            break;
+        }
+    }
+    return 0;
 }
 
 template <typename Validator>
@@ -210,16 +330,46 @@ PostingIterator* PostingDB::iter(const QByteArray& prefix, Validator validate)
     }
 
     QVector<PostingIterator*> termIterators;
+    /*
+     * Prefix and regexp queries can match thousands of terms, most of them
+     * with only a few ids. Lists which fit into a single block are merged
+     * into one sorted vector right away, only the larger ones are iterated
+     * lazily through the OrPostingIterator.
+     */
+    QVector<quint64> smallListIds;
+
+    // The larger chunks of the current term
+    QVector<TermChunkDB::Chunk> termChunks;
+    bool termMatches = false;
 
     MDB_val val;
     rc = mdb_cursor_get(cursor, &key, &val, MDB_SET_RANGE);
     while (rc == 0) {
-        const QByteArray arr(static_cast<char*>(key.mv_data), key.mv_size);
+        const int termSize = TermChunkDB::termSize(key);
+        const QByteArray arr(static_cast<char*>(key.mv_data), termSize);
         if (!arr.startsWith(prefix)) {
             break;
         }
-        if (validate(arr)) {
-            termIterators << new DBPostingIterator(val.mv_data, val.mv_size);
+
+        // The first chunk of each term comes first, the others belong to the same term
+        if (termSize == static_cast<int>(key.mv_size)) {
+            if (!termChunks.isEmpty()) {
+                termIterators << new DBPostingIterator(termChunks);
+                termChunks.clear();
+            }
+            termMatches = validate(arr);
+        }
+
+        if (termMatches) {
+            const PostingBlockReader reader(static_cast<const char*>(val.mv_data), val.mv_size);
+            if (reader.blockCount() == 1) {
+                const int offset = smallListIds.size();
+                smallListIds.resize(offset + reader.size());
+                const int len = reader.decodeBlock(0, smallListIds.data() + offset);
+                smallListIds.resize(offset + len);
+            } else if (reader.blockCount() > 1) {
+                termChunks.append({TermChunkDB::chunkStart(key), val});
+            }
         }
         rc = mdb_cursor_get(cursor, &key, &val, MDB_NEXT);
     }
@@ -229,9 +379,23 @@ PostingIterator* PostingDB::iter(const QByteArray& prefix, Validator validate)
     }
 
     mdb_cursor_close(cursor);
+
+    if (!termChunks.isEmpty()) {
+        termIterators << new DBPostingIterator(termChunks);
+    }
+
+    if (!smallListIds.isEmpty()) {
+        std::sort(smallListIds.begin(), smallListIds.end());
+        smallListIds.erase(std::unique(smallListIds.begin(), smallListIds.end()), smallListIds.end());
+        termIterators << new VectorPostingIterator(smallListIds);
+    }
+
     if (termIterators.isEmpty()) {
         return nullptr;
     }
+    if (termIterators.size() == 1) {
+        return termIterators.first();
+    }
     return new OrPostingIterator(termIterators);
 }
 
@@ -308,9 +472,9 @@ QMap<QByteArray, PostingList> PostingDB::toTestMap() const
             break;
         }
 
-        const QByteArray ba(static_cast<char*>(key.mv_data), key.mv_size);
+        const QByteArray ba(static_cast<char*>(key.mv_data), TermChunkDB::termSize(key));
         const PostingList plist = PostingCodec::decode(QByteArray(static_cast<char*>(val.mv_data), val.mv_size));
-        map.insert(ba, plist);
+        map[ba] += plist;
     }
 
     mdb_cursor_close(cursor);
@@ -9,6 +9,7 @@
 #define BALOO_POSTINGDB_H
 
 #include "postingiterator.h"
+#include "termchunkdb.h"
 
 #include <QByteArray>
 #include <QVector>
@@ -23,6 +24,10 @@ typedef QVector<quint64> PostingList;
 /**
  * The PostingDB is the main database that maps <term> -> <id1> <id2> <id2> ...
  * This is used to lookup ids when searching for a <term>.
+ *
+ * Large posting lists are split into chunks of at most ChunkSize ids, each
+ * stored under its own key (see TermChunkDB). Adding or removing an id then
+ * only rewrites the chunk containing it, instead of the whole list.
  */
 class BALOO_ENGINE_EXPORT PostingDB
 {
@@ -33,10 +38,35 @@ public:
     static MDB_dbi create(MDB_txn* txn);
     static MDB_dbi open(MDB_txn* txn);
 
+    static constexpr int ChunkSize = 4096;
+    /// Smaller chunks are merged with the following chunk when written
+    static constexpr int MinChunkSize = ChunkSize / 4;
+
     void put(const QByteArray& term, const PostingList& list);
     PostingList get(const QByteArray& term);
     void del(const QByteArray& term);
 
+    /**
+     * Returns the start ids of the chunks of \p term. Each chunk holds the
+     * ids from its start id up to the start id of the next chunk, the first
+     * chunk always starts at 0.
+     */
+    QVector<quint64> chunks(const QByteArray& term);
+    PostingList getChunk(const QByteArray& term, quint64 chunkStart);
+
+    /**
+     * Replaces the chunk starting at \p chunkStart. A \p list exceeding
+     * ChunkSize is split into equally sized chunks. A \p list below
+     * MinChunkSize is merged with the following chunk, an empty \p list
+     * without a following chunk removes the chunk.
+     */
+    void putChunk(const QByteArray& term, quint64 chunkStart, const PostingList& list);
+
+    /**
+     * The returned iterators read the posting lists directly from the
+     * database pages. They must not be used after the transaction has been
+     * finished, or after the underlying terms have been modified.
+     */
     PostingIterator* iter(const QByteArray& term);
     PostingIterator* prefixIter(const QByteArray& term);
     PostingIterator* regexpIter(const QRegularExpression& regexp, const QByteArray& prefix);
@@ -65,6 +95,7 @@ private:
 
     MDB_txn* m_txn;
     MDB_dbi m_dbi;
+    TermChunkDB m_chunkDb;
 };
 
 }
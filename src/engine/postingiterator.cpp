@@ -6,12 +6,19 @@
 
 #include "postingiterator.h"
 
+#include <limits>
+
 using namespace Baloo;
 
 PostingIterator::~PostingIterator()
 {
 }
 
+quint64 PostingIterator::estimatedSize() const
+{
+    return std::numeric_limits<quint64>::max();
+}
+
 quint64 PostingIterator::skipTo(quint64 id)
 {
     quint64 currentId = docId();
@@ -10,6 +10,10 @@
 #include <QVector>
 #include "engine_export.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 namespace Baloo {
 
 /**
@@ -26,7 +30,47 @@ public:
     virtual quint64 next() = 0;
     virtual quint64 docId() const = 0;
     virtual quint64 skipTo(quint64 docId);
+
+    /**
+     * Returns an estimate of the total number of docIds this iterator
+     * yields. Used to order the sub iterators of an intersection, rarest
+     * first. Estimates need not be exact, but 0 must only be returned for
+     * iterators which are known to be empty.
+     *
+     * The default implementation returns the maximum value, i.e. unknown.
+     */
+    virtual quint64 estimatedSize() const;
 };
+
+/**
+ * Returns the first element in the sorted range [first, last) which is not
+ * less than \p value, like std::lower_bound.
+ *
+ * The search gallops forward from \p first, doubling the step until it passes
+ * \p value, and then does a binary search in the last step. The cost is
+ * logarithmic in the distance to the result instead of the size of the range,
+ * which makes it a good fit for skipTo implementations over sorted arrays.
+ */
+template<typename Iterator, typename T, typename Compare = std::less<>>
+Iterator gallopingLowerBound(Iterator first, Iterator last, const T& value, Compare comp = Compare())
+{
+    if (first == last || !comp(*first, value)) {
+        return first;
+    }
+
+    // *lo is always less than value
+    Iterator lo = first;
+    typename std::iterator_traits<Iterator>::difference_type step = 1;
+    while (step < last - lo) {
+        Iterator probe = lo + step;
+        if (!comp(*probe, value)) {
+            return std::lower_bound(lo + 1, probe, value, comp);
+        }
+        lo = probe;
+        step *= 2;
+    }
+    return std::lower_bound(lo + 1, last, value, comp);
+}
 }
 
 #endif // BALOO_POSTINGITERATOR_H
@@ -0,0 +1,311 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "enginedebug.h"
+#include "termchunkdb.h"
+
+#include <cstring>
+
+using namespace Baloo;
+
+TermChunkDB::TermChunkDB(MDB_dbi dbi, MDB_txn* txn)
+    : m_txn(txn)
+    , m_dbi(dbi)
+{
+    Q_ASSERT(txn != nullptr);
+    Q_ASSERT(dbi != 0);
+}
+
+TermChunkDB::~TermChunkDB()
+{
+    if (m_cursor) {
+        mdb_cursor_close(m_cursor);
+    }
+}
+
+QByteArray TermChunkDB::key(const QByteArray& term, quint64 chunkStart)
+{
+    Q_ASSERT(!term.contains('\0'));
+
+    if (chunkStart == 0) {
+        return term;
+    }
+
+    QByteArray key;
+    key.reserve(term.size() + 9);
+    key.append(term);
+    key.append('\0');
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        key.append(static_cast<char>(chunkStart >> shift));
+    }
+    return key;
+}
+
+int TermChunkDB::termSize(const MDB_val& key)
+{
+    const char* data = static_cast<const char*>(key.mv_data);
+    const void* separator = std::memchr(data, '\0', key.mv_size);
+    return separator ? static_cast<const char*>(separator) - data : key.mv_size;
+}
+
+quint64 TermChunkDB::chunkStart(const MDB_val& key)
+{
+    const int size = termSize(key);
+    if (key.mv_size != static_cast<size_t>(size) + 9) {
+        return 0;
+    }
+
+    const unsigned char* p = static_cast<const unsigned char*>(key.mv_data) + size + 1;
+    quint64 start = 0;
+    for (int i = 0; i < 8; i++) {
+        start = (start << 8) | p[i];
+    }
+    return start;
+}
+
+QVector<TermChunkDB::Chunk> TermChunkDB::chunks(const QByteArray& term) const
+{
+    Q_ASSERT(!term.isEmpty());
+
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return {};
+    }
+
+    MDB_val key;
+    key.mv_size = term.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+
+    QVector<Chunk> chunks;
+    MDB_val val;
+    int rc = mdb_cursor_get(cur, &key, &val, MDB_SET_RANGE);
+    while (rc == 0) {
+        if (termSize(key) != term.size() || std::memcmp(key.mv_data, term.constData(), term.size()) != 0) {
+            break;
+        }
+        chunks.append({chunkStart(key), val});
+        rc = mdb_cursor_get(cur, &key, &val, MDB_NEXT);
+    }
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCWarning(ENGINE) << "TermChunkDB::chunks" << term << mdb_strerror(rc);
+    }
+
+    return chunks;
+}
+
+QVector<quint64> TermChunkDB::chunkStarts(const QByteArray& term) const
+{
+    const QVector<Chunk> allChunks = chunks(term);
+
+    QVector<quint64> starts;
+    starts.reserve(allChunks.size());
+    for (const Chunk& chunk : allChunks) {
+        starts << chunk.start;
+    }
+    return starts;
+}
+
+TermChunkDB::Chunk TermChunkDB::nextChunk(const QByteArray& term, quint64 chunkStart) const
+{
+    Q_ASSERT(!term.isEmpty());
+
+    Chunk chunk{0, {0, nullptr}};
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return chunk;
+    }
+
+    // The keys of the following chunks sort after the one of chunkStart + 1
+    const QByteArray nextKey = key(term, chunkStart + 1);
+
+    MDB_val key;
+    key.mv_size = nextKey.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(nextKey.constData()));
+
+    MDB_val val;
+    int rc = mdb_cursor_get(cur, &key, &val, MDB_SET_RANGE);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "TermChunkDB::nextChunk" << term << chunkStart << mdb_strerror(rc);
+        }
+        return chunk;
+    }
+    if (termSize(key) != term.size() || std::memcmp(key.mv_data, term.constData(), term.size()) != 0) {
+        return chunk;
+    }
+
+    chunk.start = TermChunkDB::chunkStart(key);
+    chunk.data = val;
+    return chunk;
+}
+
+TermChunkDB::Chunk TermChunkDB::chunkContaining(const QByteArray& term, quint64 id) const
+{
+    Q_ASSERT(!term.isEmpty());
+
+    Chunk chunk{0, {0, nullptr}};
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return chunk;
+    }
+
+    // The chunk is the last one sorting before the key of id + 1
+    const QByteArray nextKey = key(term, id + 1);
+
+    MDB_val key;
+    key.mv_size = nextKey.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(nextKey.constData()));
+
+    MDB_val val;
+    int rc = mdb_cursor_get(cur, &key, &val, MDB_SET_RANGE);
+    if (rc == 0) {
+        rc = mdb_cursor_get(cur, &key, &val, MDB_PREV);
+    } else if (rc == MDB_NOTFOUND) {
+        rc = mdb_cursor_get(cur, &key, &val, MDB_LAST);
+    }
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "TermChunkDB::chunkContaining" << term << id << mdb_strerror(rc);
+        }
+        return chunk;
+    }
+    if (termSize(key) != term.size() || std::memcmp(key.mv_data, term.constData(), term.size()) != 0) {
+        return chunk;
+    }
+
+    chunk.start = chunkStart(key);
+    chunk.data = val;
+    return chunk;
+}
+
+QByteArray TermChunkDB::get(const QByteArray& term, quint64 chunkStart) const
+{
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return QByteArray();
+    }
+
+    const QByteArray chunkKey = key(term, chunkStart);
+
+    MDB_val key;
+    key.mv_size = chunkKey.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(chunkKey.constData()));
+
+    MDB_val val{0, nullptr};
+    int rc = mdb_cursor_get(cur, &key, &val, MDB_SET_KEY);
+    if (rc) {
+        if (rc != MDB_NOTFOUND) {
+            qCDebug(ENGINE) << "TermChunkDB::get" << term << chunkStart << mdb_strerror(rc);
+        }
+        return QByteArray();
+    }
+
+    return QByteArray::fromRawData(static_cast<char*>(val.mv_data), val.mv_size);
+}
+
+void TermChunkDB::put(const QByteArray& term, quint64 chunkStart, const QByteArray& data)
+{
+    Q_ASSERT(!term.isEmpty());
+    Q_ASSERT(!data.isEmpty());
+
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return;
+    }
+
+    const QByteArray chunkKey = key(term, chunkStart);
+
+    MDB_val key;
+    key.mv_size = chunkKey.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(chunkKey.constData()));
+
+    MDB_val val;
+    val.mv_size = data.size();
+    val.mv_data = static_cast<void*>(const_cast<char*>(data.constData()));
+
+    int rc = mdb_cursor_put(cur, &key, &val, 0);
+    if (rc) {
+        qCWarning(ENGINE) << "TermChunkDB::put" << mdb_strerror(rc);
+    }
+}
+
+void TermChunkDB::del(const QByteArray& term, quint64 chunkStart)
+{
+    Q_ASSERT(!term.isEmpty());
+
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return;
+    }
+
+    quint64 delStart = chunkStart;
+    if (chunkStart == 0) {
+        // Keep the first chunk, so the term can be looked up directly
+        const QVector<Chunk> allChunks = chunks(term);
+        if (allChunks.size() > 1) {
+            const MDB_val& next = allChunks[1].data;
+            put(term, 0, QByteArray(static_cast<const char*>(next.mv_data), next.mv_size));
+            delStart = allChunks[1].start;
+        }
+    }
+
+    const QByteArray chunkKey = key(term, delStart);
+
+    MDB_val key;
+    key.mv_size = chunkKey.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(chunkKey.constData()));
+
+    int rc = mdb_cursor_get(cur, &key, nullptr, MDB_SET);
+    if (rc == 0) {
+        rc = mdb_cursor_del(cur, 0);
+    }
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "TermChunkDB::del" << term << chunkStart << mdb_strerror(rc);
+    }
+}
+
+void TermChunkDB::delAll(const QByteArray& term)
+{
+    Q_ASSERT(!term.isEmpty());
+
+    MDB_cursor* cur = cursor();
+    if (!cur) {
+        return;
+    }
+
+    MDB_val key;
+    key.mv_size = term.size();
+    key.mv_data = static_cast<void*>(const_cast<char*>(term.constData()));
+
+    int rc = mdb_cursor_get(cur, &key, nullptr, MDB_SET_RANGE);
+    while (rc == 0) {
+        if (termSize(key) != term.size() || std::memcmp(key.mv_data, term.constData(), term.size()) != 0) {
+            break;
+        }
+        rc = mdb_cursor_del(cur, 0);
+        if (rc) {
+            break;
+        }
+        // After a delete, MDB_NEXT returns the entry following the deleted one
+        rc = mdb_cursor_get(cur, &key, nullptr, MDB_NEXT);
+    }
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        qCDebug(ENGINE) << "TermChunkDB::delAll" << term << mdb_strerror(rc);
+    }
+}
+
+MDB_cursor* TermChunkDB::cursor() const
+{
+    if (!m_cursor) {
+        int rc = mdb_cursor_open(m_txn, m_dbi, &m_cursor);
+        if (rc) {
+            qCWarning(ENGINE) << "TermChunkDB::cursor" << mdb_strerror(rc);
+            m_cursor = nullptr;
+        }
+    }
+    return m_cursor;
+}
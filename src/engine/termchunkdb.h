@@ -0,0 +1,106 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_TERMCHUNKDB_H
+#define BALOO_TERMCHUNKDB_H
+
+#include "engine_export.h"
+
+#include <QByteArray>
+#include <QVector>
+#include <lmdb.h>
+
+namespace Baloo {
+
+/**
+ * Stores the value of a term split into chunks, each chunk covering a range
+ * of document ids. Used by the PostingDB and the PositionDB, which encode
+ * the values.
+ *
+ * The first chunk is stored under the term itself, all following chunks
+ * under the term, a '\0' separator and the first id of the chunk as 8 byte
+ * big endian value. Terms never contain '\0' (see DocTermsCodec), so the
+ * chunks of a term are adjacent and sorted by their start id. The first
+ * chunk always exists as long as the term has any chunks.
+ *
+ * All lookups and writes go through a single cursor, which is kept open
+ * for the lifetime of the object. When the terms are accessed in key order,
+ * as WriteTransaction::commit() does, most lookups stay on the current page
+ * instead of searching the tree from the root.
+ */
+class BALOO_ENGINE_NO_EXPORT TermChunkDB
+{
+public:
+    TermChunkDB(MDB_dbi dbi, MDB_txn* txn);
+    ~TermChunkDB();
+    TermChunkDB(const TermChunkDB&) = delete;
+    TermChunkDB& operator=(const TermChunkDB&) = delete;
+
+    struct Chunk {
+        quint64 start;
+        MDB_val data;
+    };
+
+    static QByteArray key(const QByteArray& term, quint64 chunkStart);
+
+    /**
+     * The length of the term in the database \p key
+     */
+    static int termSize(const MDB_val& key);
+
+    /**
+     * The start id of the chunk stored under the database \p key
+     */
+    static quint64 chunkStart(const MDB_val& key);
+
+    /**
+     * Returns all chunks of \p term. The data points into the database
+     * pages, and becomes invalid once the database is modified.
+     */
+    QVector<Chunk> chunks(const QByteArray& term) const;
+    QVector<quint64> chunkStarts(const QByteArray& term) const;
+
+    /**
+     * Returns the chunk of \p term following the one at \p chunkStart, the
+     * data is empty if there is none. The data points into the database
+     * pages, like for chunks().
+     */
+    Chunk nextChunk(const QByteArray& term, quint64 chunkStart) const;
+
+    /**
+     * Returns the chunk of \p term whose range covers \p id, the data is
+     * empty if the term does not exist. Only the one chunk is looked up.
+     */
+    Chunk chunkContaining(const QByteArray& term, quint64 id) const;
+
+    QByteArray get(const QByteArray& term, quint64 chunkStart) const;
+    void put(const QByteArray& term, quint64 chunkStart, const QByteArray& data);
+
+    /**
+     * Removes a single chunk. When removing the first chunk, the next
+     * chunk is moved in its place.
+     */
+    void del(const QByteArray& term, quint64 chunkStart);
+
+    /**
+     * Removes all chunks of \p term
+     */
+    void delAll(const QByteArray& term);
+
+private:
+    MDB_cursor* cursor() const;
+
+    MDB_txn* m_txn;
+    MDB_dbi m_dbi;
+    mutable MDB_cursor* m_cursor = nullptr;
+};
+
+}
+
+Q_DECLARE_TYPEINFO(Baloo::TermChunkDB::Chunk, Q_PRIMITIVE_TYPE);
+
+#endif // BALOO_TERMCHUNKDB_H
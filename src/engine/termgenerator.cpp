@@ -9,12 +9,28 @@
 
 #include <QTextBoundaryFinder>
 
+#include <algorithm>
+
 using namespace Baloo;
 
 namespace {
 
+bool isAscii(QStringView text)
+{
+    // Written without early exit, so the compiler can vectorize it
+    char16_t bits = 0;
+    for (const QChar c : text) {
+        bits |= c.unicode();
+    }
+    return bits < 0x80;
+}
+
 QString normalizeTerm(const QString &str)
 {
+    if (isAscii(str)) {
+        return str.toLower();
+    }
+
     // Remove all accents. It is important to call toLower after normalization,
     // since some exotic unicode symbols can remain uppercase
     const QString denormalized = str.normalized(QString::NormalizationForm_KD).toLower();
@@ -38,20 +54,7 @@ void appendTerm(QByteArrayList &list, const QString &term)
     }
 }
 
-}
-
-TermGenerator::TermGenerator(Document& doc)
-    : m_doc(doc)
-    , m_position(1)
-{
-}
-
-void TermGenerator::indexText(const QString& text)
-{
-    indexText(text, QByteArray());
-}
-
-QByteArrayList TermGenerator::termList(const QString& text_)
+void appendTerms(QByteArrayList &list, const QString &text_)
 {
     QString text(text_);
     text.replace(QLatin1Char('_'), QLatin1Char(' '));
@@ -62,7 +65,6 @@ QByteArrayList TermGenerator::termList(const QString& text_)
         return c.isPunct() || c.isMark() || c.isSpace() || (!c.isPrint() && !c.isSurrogate());
     };
 
-    QByteArrayList list;
     QTextBoundaryFinder bf(QTextBoundaryFinder::Word, text);
     for (; bf.position() != -1; bf.toNextBoundary()) {
         int end = bf.position();
@@ -93,21 +95,180 @@ QByteArrayList TermGenerator::termList(const QString& text_)
             start = end;
         }
     }
+}
+
+/*
+ * The ASCII fast path. For 7-bit text the word boundaries of
+ * QTextBoundaryFinder reduce to a few rules:
+ *
+ * - Letters and digits form words, a single '\'' between two letters and a
+ *   single '.', ',' or ';' between two digits do not break them. Qt treats
+ *   the '.' like a ',', so "file.txt" is split, but "3.14" is not.
+ * - Punctuation, spaces and control characters separate the terms.
+ * - The remaining symbols ("$+<=>^`|~") are not skipped by appendTerms(),
+ *   runs of them become a term of their own.
+ *
+ * A ':' between letters and a '\'' between digits depend on the Unicode
+ * version and tailoring, the fast path gives up on those lines.
+ *
+ * Normalizing ASCII is just lowercasing.
+ */
+inline bool isAsciiLetter(char16_t c)
+{
+    return (c | 0x20) >= u'a' && (c | 0x20) <= u'z';
+}
+
+inline bool isAsciiDigit(char16_t c)
+{
+    return c >= u'0' && c <= u'9';
+}
+
+inline bool isAsciiSymbol(char16_t c)
+{
+    switch (c) {
+    case u'$': case u'+': case u'<': case u'=': case u'>':
+    case u'^': case u'`': case u'|': case u'~':
+        return true;
+    default:
+        return false;
+    }
+}
+
+void appendAsciiTerm(QByteArrayList &list, QStringView term)
+{
+    const qsizetype size = std::min<qsizetype>(term.size(), TermGenerator::maxTermSize);
+    QByteArray arr(size, Qt::Uninitialized);
+    char* data = arr.data();
+    for (qsizetype i = 0; i < size; ++i) {
+        const char16_t c = term[i].unicode();
+        data[i] = (c >= u'A' && c <= u'Z') ? char(c | 0x20) : char(c);
+    }
+    list << arr;
+}
+
+bool appendAsciiTerms(QByteArrayList &list, QStringView text)
+{
+    const qsizetype size = text.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const char16_t c = text[i].unicode();
+        const qsizetype start = i++;
+
+        if (isAsciiLetter(c) || isAsciiDigit(c)) {
+            bool numeric = isAsciiDigit(c);
+            while (i < size) {
+                const char16_t n = text[i].unicode();
+                if (isAsciiLetter(n)) {
+                    numeric = false;
+                    ++i;
+                } else if (isAsciiDigit(n)) {
+                    numeric = true;
+                    ++i;
+                } else if (i + 1 < size) {
+                    const char16_t next = text[i + 1].unicode();
+                    if (numeric ? (n == u'\'' && isAsciiDigit(next)) : (n == u':' && isAsciiLetter(next))) {
+                        return false;
+                    }
+                    const bool midLetter = n == u'\'' && isAsciiLetter(next);
+                    const bool midNum = (n == u'.' || n == u',' || n == u';') && isAsciiDigit(next);
+                    if (numeric ? !midNum : !midLetter) {
+                        break;
+                    }
+                    i += 2;
+                } else {
+                    break;
+                }
+            }
+            appendAsciiTerm(list, text.mid(start, i - start));
+        } else if (isAsciiSymbol(c)) {
+            while (i < size && isAsciiSymbol(text[i].unicode())) {
+                ++i;
+            }
+            appendAsciiTerm(list, text.mid(start, i - start));
+        }
+    }
+    return true;
+}
+
+}
+
+TermGenerator::TermGenerator(Document& doc)
+    : m_doc(doc)
+    , m_position(1)
+{
+}
+
+void TermGenerator::indexText(const QString& text)
+{
+    indexText(text, QByteArray());
+}
+
+QByteArrayList TermGenerator::termList(const QString& text)
+{
+    // There is always a word boundary after a line feed, so the text can be
+    // split into lines. ASCII lines take the fast path, the others are
+    // collected and go through QTextBoundaryFinder and the normalization.
+    QByteArrayList list;
+    const QStringView view(text);
+    qsizetype slowStart = 0;
+    qsizetype lineStart = 0;
+
+    while (lineStart < view.size()) {
+        qsizetype lineEnd = view.indexOf(QLatin1Char('\n'), lineStart);
+        lineEnd = lineEnd < 0 ? view.size() : lineEnd + 1;
+
+        const QStringView line = view.mid(lineStart, lineEnd - lineStart);
+        if (isAscii(line)) {
+            if (slowStart < lineStart) {
+                appendTerms(list, text.mid(slowStart, lineStart - slowStart));
+            }
+            const qsizetype listSize = list.size();
+            if (appendAsciiTerms(list, line)) {
+                slowStart = lineEnd;
+            } else {
+                list.erase(list.begin() + listSize, list.end());
+                slowStart = lineStart;
+            }
+        }
+        lineStart = lineEnd;
+    }
+    if (slowStart < view.size()) {
+        appendTerms(list, text.mid(slowStart));
+    }
+
     return list;
 }
 
+void TermGenerator::setMaxTerms(int maxTerms)
+{
+    m_maxTerms = maxTerms;
+}
+
+bool TermGenerator::acceptTerm(const QByteArray& term)
+{
+    if (m_maxTerms <= 0 || m_doc.termCount() < m_maxTerms || m_doc.hasTerm(term)) {
+        return true;
+    }
+    m_droppedTerms++;
+    return false;
+}
+
 void TermGenerator::indexText(const QString& text, const QByteArray& prefix)
 {
     const QByteArrayList terms = termList(text);
     if (terms.size() == 1) {
         QByteArray finalArr = prefix + terms[0];
-        m_doc.addTerm(finalArr);
+        if (acceptTerm(finalArr)) {
+            m_doc.addTerm(finalArr);
+        }
         return;
     }
     for (const QByteArray& term : terms) {
         QByteArray finalArr = prefix + term;
 
-        m_doc.addPositionTerm(finalArr, m_position);
+        if (acceptTerm(finalArr)) {
+            m_doc.addPositionTerm(finalArr, m_position);
+        }
         m_position++;
     }
     m_position++;
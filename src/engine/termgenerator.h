@@ -33,13 +33,30 @@ public:
     void setPosition(int position);
     int position() const;
 
+    /**
+     * Once the document has \p maxTerms terms, indexText() only adds the
+     * terms it has already, new terms are dropped. 0 disables the limit.
+     */
+    void setMaxTerms(int maxTerms);
+
+    /**
+     * The number of term occurrences dropped because of the limit
+     */
+    int droppedTerms() const {
+        return m_droppedTerms;
+    }
+
     static QByteArrayList termList(const QString& text);
 
     // Trim all terms to this size
     const static int maxTermSize = 25;
 private:
+    bool acceptTerm(const QByteArray& term);
+
     Document& m_doc;
     int m_position;
+    int m_maxTerms = 0;
+    int m_droppedTerms = 0;
 };
 }
 
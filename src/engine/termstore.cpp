@@ -0,0 +1,188 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "termstore.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Baloo;
+
+void TermStore::add(QByteArrayView term)
+{
+    Q_ASSERT(!term.isEmpty());
+    if (find(term) < 0) {
+        unseal();
+        findOrInsert(term);
+    }
+}
+
+void TermStore::add(QByteArrayView term, uint position)
+{
+    Q_ASSERT(!term.isEmpty());
+    unseal();
+    const quint32 record = findOrInsert(term);
+    Record& r = m_records[record];
+    if (r.positionCount < quint32(maxPositions)) {
+        r.positionCount++;
+        m_occurrences.append({record, position});
+    }
+}
+
+void TermStore::clear()
+{
+    m_buffer.clear();
+    m_records.clear();
+    m_hashTable.clear();
+    m_occurrences.clear();
+    m_positions.clear();
+    m_order.clear();
+    m_sealed = true;
+}
+
+int TermStore::find(QByteArrayView term) const
+{
+    if (m_hashTable.isEmpty()) {
+        return -1;
+    }
+
+    const quint32 mask = m_hashTable.size() - 1;
+    for (quint32 i = qHash(term) & mask; ; i = (i + 1) & mask) {
+        const quint32 slot = m_hashTable[i];
+        if (!slot) {
+            return -1;
+        }
+        if (termAt(slot - 1) == term) {
+            return slot - 1;
+        }
+    }
+}
+
+quint32 TermStore::findOrInsert(QByteArrayView term)
+{
+    // Keep the load factor below 1/2
+    if ((m_records.size() + 1) * 2 > m_hashTable.size()) {
+        rehash(std::max<int>(16, m_hashTable.size() * 2));
+    }
+
+    const quint32 mask = m_hashTable.size() - 1;
+    quint32* table = m_hashTable.data();
+    for (quint32 i = qHash(term) & mask; ; i = (i + 1) & mask) {
+        const quint32 slot = table[i];
+        if (!slot) {
+            m_records.append({quint32(m_buffer.size()), quint32(term.size()), 0, 0});
+            m_buffer.append(term.data(), term.size());
+            table[i] = quint32(m_records.size());
+            return m_records.size() - 1;
+        }
+        if (termAt(slot - 1) == term) {
+            return slot - 1;
+        }
+    }
+}
+
+void TermStore::rehash(int size)
+{
+    m_hashTable.fill(0, size);
+
+    const quint32 mask = size - 1;
+    quint32* table = m_hashTable.data();
+    for (int record = 0; record < m_records.size(); ++record) {
+        quint32 i = qHash(termAt(record)) & mask;
+        while (table[i]) {
+            i = (i + 1) & mask;
+        }
+        table[i] = quint32(record + 1);
+    }
+}
+
+void TermStore::seal() const
+{
+    if (m_sealed) {
+        return;
+    }
+
+    m_order.resize(m_records.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(), [this](quint32 lhs, quint32 rhs) {
+        return termAt(lhs) < termAt(rhs);
+    });
+
+    // Point each record past the end of its range, and fill it backwards,
+    // so the positions stay in insertion order
+    quint32 end = 0;
+    for (Record& r : m_records) {
+        end += r.positionCount;
+        r.positionStart = end;
+    }
+    m_positions.resize(end);
+    for (auto it = m_occurrences.crbegin(); it != m_occurrences.crend(); ++it) {
+        m_positions[--m_records[it->record].positionStart] = it->position;
+    }
+
+    m_occurrences.clear();
+    m_occurrences.squeeze();
+    m_sealed = true;
+}
+
+void TermStore::unseal()
+{
+    if (!m_sealed) {
+        return;
+    }
+
+    m_occurrences.reserve(m_positions.size());
+    for (int record = 0; record < m_records.size(); ++record) {
+        const Record& r = m_records[record];
+        for (quint32 i = 0; i < r.positionCount; ++i) {
+            m_occurrences.append({quint32(record), m_positions[r.positionStart + i]});
+        }
+    }
+
+    m_positions.clear();
+    m_order.clear();
+    m_sealed = false;
+}
+
+TermStore::Entry TermStore::at(int i) const
+{
+    Q_ASSERT(i >= 0 && i < m_records.size());
+    seal();
+
+    const quint32 record = m_order[i];
+    const Record& r = m_records[record];
+
+    Entry entry;
+    entry.m_term = termAt(record);
+    entry.m_positions = m_positions.constData() + r.positionStart;
+    entry.m_positionCount = r.positionCount;
+    return entry;
+}
+
+QList<QByteArray> TermStore::keys() const
+{
+    QList<QByteArray> list;
+    list.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        list << at(i).term().toByteArray();
+    }
+    return list;
+}
+
+QVector<uint> TermStore::positions(QByteArrayView term) const
+{
+    const int record = find(term);
+    if (record < 0) {
+        return QVector<uint>();
+    }
+
+    seal();
+    const Record& r = m_records[record];
+    return QVector<uint>(m_positions.constData() + r.positionStart, m_positions.constData() + r.positionStart + r.positionCount);
+}
@@ -0,0 +1,129 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_TERMSTORE_H
+#define BALOO_TERMSTORE_H
+
+#include "engine_export.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QVector>
+
+namespace Baloo {
+
+/**
+ * The terms of a Document, along with their positions.
+ *
+ * A document can have tens of thousands of terms. Instead of a map node, a
+ * key and a position vector per term, the term bytes are kept in one buffer,
+ * and the positions in one vector. Lookups go through an open addressing
+ * hash table of record indices.
+ *
+ * The positions are appended in insertion order, tagged with their term.
+ * On the first read access they are grouped per term and the terms are
+ * sorted, see seal().
+ */
+class BALOO_ENGINE_EXPORT TermStore
+{
+public:
+    /**
+     * Only the first positions of a term are kept, further occurrences
+     * are dropped.
+     */
+    static constexpr int maxPositions = 1024;
+
+    /**
+     * Adds \p term without a position, if it does not exist yet
+     */
+    void add(QByteArrayView term);
+    void add(QByteArrayView term, uint position);
+
+    int size() const {
+        return m_records.size();
+    }
+    bool contains(QByteArrayView term) const {
+        return find(term) >= 0;
+    }
+    bool isEmpty() const {
+        return m_records.isEmpty();
+    }
+    void clear();
+
+    class Entry {
+    public:
+        QByteArrayView term() const {
+            return m_term;
+        }
+        int positionCount() const {
+            return m_positionCount;
+        }
+        const uint* positionData() const {
+            return m_positions;
+        }
+        QVector<uint> positions() const {
+            return QVector<uint>(m_positions, m_positions + m_positionCount);
+        }
+
+    private:
+        QByteArrayView m_term;
+        const uint* m_positions = nullptr;
+        int m_positionCount = 0;
+
+        friend class TermStore;
+    };
+
+    /**
+     * The \p i th term in sorted order. The entry is valid until the
+     * terms are modified.
+     */
+    Entry at(int i) const;
+
+    QList<QByteArray> keys() const;
+    QVector<uint> positions(QByteArrayView term) const;
+
+private:
+    struct Record {
+        quint32 offset;
+        quint32 size;
+        quint32 positionCount;
+        // Start in m_positions, once sealed
+        quint32 positionStart;
+    };
+
+    struct Occurrence {
+        quint32 record;
+        uint position;
+    };
+
+    QByteArrayView termAt(quint32 record) const {
+        const Record& r = m_records[record];
+        return QByteArrayView(m_buffer.constData() + r.offset, r.size);
+    }
+
+    int find(QByteArrayView term) const;
+    quint32 findOrInsert(QByteArrayView term);
+    void rehash(int size);
+
+    // Groups the positions by term and sorts the terms
+    void seal() const;
+    void unseal();
+
+    QByteArray m_buffer;
+    mutable QVector<Record> m_records;
+    // Record index + 1, 0 for an empty slot
+    QVector<quint32> m_hashTable;
+
+    mutable QVector<Occurrence> m_occurrences;
+    mutable QVector<uint> m_positions;
+    mutable QVector<quint32> m_order;
+    mutable bool m_sealed = true;
+};
+
+}
+
+#endif // BALOO_TERMSTORE_H
@@ -6,9 +6,13 @@
 */
 
 #include "transaction.h"
+#include "bulkloader.h"
 #include "documentdb.h"
 #include "documenturldb.h"
 #include "documentiddb.h"
+#include "contentindexingqueuedb.h"
+#include "contenthashdb.h"
+#include "folderfingerprintdb.h"
 #include "positiondb.h"
 #include "documentdatadb.h"
 
@@ -48,18 +52,22 @@ void Transaction::reset(TransactionType type)
     init(type);
 }
 
-void Transaction::init(TransactionType type)
+bool Transaction::init(TransactionType type)
 {
     uint flags = type == ReadOnly ? MDB_RDONLY : 0;
     int rc = mdb_txn_begin(m_env, nullptr, flags, &m_txn);
     if (rc) {
         qCDebug(ENGINE) << "Transaction" << mdb_strerror(rc);
-        return;
+        m_txn = nullptr;
+        return false;
     }
 
     if (type == ReadWrite) {
         m_writeTrans = std::make_unique<WriteTransaction>(m_dbis, m_txn);
+        m_writeTrans->setBulkLoader(m_bulkLoader);
+        m_writeTrans->setMemoryBudget(m_memoryBudget);
     }
+    return true;
 }
 
 Transaction::Transaction(Database* db, Transaction::TransactionType type)
@@ -146,6 +154,19 @@ DocumentTimeDB::TimeInfo Transaction::documentTimeInfo(quint64 id) const
     return docTimeDb.get(id);
 }
 
+void Transaction::folderTimeInfo(quint64 parentId, QVector<quint64>& ids, QVector<DocumentTimeDB::TimeInfo>& timeInfos) const
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(parentId > 0);
+
+    ids.clear();
+    IdTreeDB idTreeDb(m_dbis.idTreeDbi, m_txn);
+    idTreeDb.appendTo(parentId, ids);
+
+    DocumentTimeDB docTimeDb(m_dbis.docTimeDbi, m_txn);
+    timeInfos = docTimeDb.get(ids);
+}
+
 QByteArray Transaction::documentData(quint64 id) const
 {
     Q_ASSERT(m_txn);
@@ -155,13 +176,74 @@ QByteArray Transaction::documentData(quint64 id) const
     return docDataDb.get(id);
 }
 
+QByteArray Transaction::documentContentHash(quint64 id) const
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(id > 0);
+
+    ContentHashDB contentHashDb(m_dbis.contentHashDbi, m_dbis.contentHashIdDbi, m_txn);
+    return contentHashDb.get(id);
+}
+
+quint64 Transaction::documentWithContentHash(const QByteArray& hash) const
+{
+    Q_ASSERT(m_txn);
+
+    ContentHashDB contentHashDb(m_dbis.contentHashDbi, m_dbis.contentHashIdDbi, m_txn);
+    return contentHashDb.documentWithHash(hash);
+}
+
+bool Transaction::hasContentHashWithPrefix(const QByteArray& prefix) const
+{
+    Q_ASSERT(m_txn);
+
+    ContentHashDB contentHashDb(m_dbis.contentHashDbi, m_dbis.contentHashIdDbi, m_txn);
+    return contentHashDb.hasHashWithPrefix(prefix);
+}
+
+bool Transaction::folderFingerprint(quint64 id, FolderFingerprintDB::Fingerprint& fingerprint) const
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(id > 0);
+
+    FolderFingerprintDB folderFingerprintDb(m_dbis.folderFingerprintDbi, m_txn);
+    return folderFingerprintDb.get(id, fingerprint);
+}
+
+Document Transaction::documentContents(quint64 id) const
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(id > 0);
+
+    DocumentDB documentTermsDB(m_dbis.docTermsDbi, m_txn);
+    PositionDB positionDb(m_dbis.positionDBi, m_txn);
+    DocumentDataDB docDataDb(m_dbis.docDataDbi, m_txn);
+
+    Document doc;
+    doc.setId(id);
+
+    const QVector<QByteArray> terms = documentTermsDB.get(id);
+    for (const QByteArray& term : terms) {
+        const QVector<uint> positions = positionDb.positions(term, id);
+        if (positions.isEmpty()) {
+            doc.addTerm(term);
+        }
+        for (uint position : positions) {
+            doc.addPositionTerm(term, position);
+        }
+    }
+    doc.setData(docDataDb.get(id));
+
+    return doc;
+}
+
 QVector<quint64> Transaction::fetchPhaseOneIds(int size) const
 {
     Q_ASSERT(m_txn);
     Q_ASSERT(size > 0);
 
-    DocumentIdDB contentIndexingDb(m_dbis.contentIndexingDbi, m_txn);
-    return contentIndexingDb.fetchItems(size);
+    ContentIndexingQueueDB queueDb(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
+    return queueDb.fetchItems(size);
 }
 
 QVector<QByteArray> Transaction::fetchTermsStartingWith(const QByteArray& term) const
@@ -191,14 +273,14 @@ uint Transaction::size() const
 //
 // Write Operations
 //
-void Transaction::setPhaseOne(quint64 id)
+void Transaction::setPhaseOne(quint64 id, quint32 priority)
 {
     Q_ASSERT(m_txn);
     Q_ASSERT(id > 0);
     Q_ASSERT(m_writeTrans);
 
-    DocumentIdDB contentIndexingDb(m_dbis.contentIndexingDbi, m_txn);
-    contentIndexingDb.put(id);
+    ContentIndexingQueueDB queueDb(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
+    queueDb.put(id, priority);
 }
 
 void Transaction::removePhaseOne(quint64 id)
@@ -207,8 +289,28 @@ void Transaction::removePhaseOne(quint64 id)
     Q_ASSERT(id > 0);
     Q_ASSERT(m_writeTrans);
 
-    DocumentIdDB contentIndexingDb(m_dbis.contentIndexingDbi, m_txn);
-    contentIndexingDb.del(id);
+    ContentIndexingQueueDB queueDb(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
+    queueDb.del(id);
+}
+
+void Transaction::setDocumentContentHash(quint64 id, const QByteArray& hash)
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(id > 0);
+    Q_ASSERT(m_writeTrans);
+
+    ContentHashDB contentHashDb(m_dbis.contentHashDbi, m_dbis.contentHashIdDbi, m_txn);
+    contentHashDb.put(id, hash);
+}
+
+void Transaction::setFolderFingerprint(quint64 id, const FolderFingerprintDB::Fingerprint& fingerprint)
+{
+    Q_ASSERT(m_txn);
+    Q_ASSERT(id > 0);
+    Q_ASSERT(m_writeTrans);
+
+    FolderFingerprintDB folderFingerprintDb(m_dbis.folderFingerprintDbi, m_txn);
+    folderFingerprintDb.put(id, fingerprint);
 }
 
 void Transaction::addFailed(quint64 id)
@@ -274,6 +376,48 @@ void Transaction::replaceDocument(const Document& doc, DocumentOperations operat
     m_writeTrans->replaceDocument(doc, operations);
 }
 
+void Transaction::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+    if (m_writeTrans) {
+        m_writeTrans->setMemoryBudget(bytes);
+    }
+}
+
+void Transaction::setBulkLoader(BulkLoader* loader)
+{
+    m_bulkLoader = loader;
+    if (m_writeTrans) {
+        m_writeTrans->setBulkLoader(loader);
+    }
+}
+
+bool Transaction::finishBulkLoad()
+{
+    Q_ASSERT(m_txn);
+    if (!m_writeTrans || !m_bulkLoader) {
+        qCWarning(ENGINE) << "m_writeTrans or m_bulkLoader is null";
+        return false;
+    }
+
+    m_writeTrans->commit();
+
+    // Commit in between, so a single transaction does not dirty the pages
+    // of the whole index
+    bool done = false;
+    bool ok = m_bulkLoader->finish(m_dbis, m_txn, done);
+    while (ok && !done) {
+        if (!commit() || !init(ReadWrite)) {
+            qCWarning(ENGINE) << "Transaction::finishBulkLoad: could not continue with the next part";
+            setBulkLoader(nullptr);
+            return false;
+        }
+        ok = m_bulkLoader->finish(m_dbis, m_txn, done);
+    }
+    setBulkLoader(nullptr);
+    return ok;
+}
+
 bool Transaction::commit()
 {
     Q_ASSERT(m_txn);
@@ -336,7 +480,7 @@ PostingIterator* Transaction::postingIterator(const EngineQuery& query) const
             qCDebug(ENGINE) << "Degenerated Phrase with 1 Term:" <<  query;
             return postingIterator(subQueries[0]);
         }
-        QVector<VectorPositionInfoIterator*> vec;
+        QVector<PositionInfoIterator*> vec;
         vec.reserve(subQueries.size());
         for (const EngineQuery& q : subQueries) {
             if (!q.leaf()) {
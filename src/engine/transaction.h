@@ -13,6 +13,7 @@
 #include "postingdb.h"
 #include "writetransaction.h"
 #include "documenttimedb.h"
+#include "folderfingerprintdb.h"
 #include <functional>
 #include <memory>
 
@@ -20,6 +21,7 @@
 
 namespace Baloo {
 
+class BulkLoader;
 class Database;
 class Document;
 class PostingIterator;
@@ -56,6 +58,45 @@ public:
 
     DocumentTimeDB::TimeInfo documentTimeInfo(quint64 id) const;
 
+    /**
+     * The sorted ids of the documents in the folder \p parentId, and their
+     * times in \p timeInfos. Cheaper than a documentTimeInfo() and a
+     * hasDocument() per document when comparing a folder with the index.
+     */
+    void folderTimeInfo(quint64 parentId, QVector<quint64>& ids, QVector<DocumentTimeDB::TimeInfo>& timeInfos) const;
+
+    /**
+     * The hash of the file contents the terms and data of \p id were
+     * extracted from, see ContentHashDB. Empty if not known.
+     */
+    QByteArray documentContentHash(quint64 id) const;
+
+    /**
+     * A document extracted from contents with the given \p hash, or 0
+     */
+    quint64 documentWithContentHash(const QByteArray& hash) const;
+
+    /**
+     * Returns true if any document has a content hash starting with \p prefix
+     */
+    bool hasContentHashWithPrefix(const QByteArray& prefix) const;
+
+    /**
+     * The fingerprint of the folder \p id stored by the last crawl, returns
+     * false if there is none. See FolderFingerprintDB.
+     */
+    bool folderFingerprint(quint64 id, FolderFingerprintDB::Fingerprint& fingerprint) const;
+
+    /**
+     * The terms, with their positions, and the data of \p id. Used to
+     * reuse the extracted contents for a copy of the file.
+     */
+    Document documentContents(quint64 id) const;
+
+    /*
+     * The iterators read directly from the database and are only
+     * valid for the lifetime of the transaction.
+     */
     PostingIterator* postingIterator(const EngineQuery& query) const;
     PostingIterator* postingCompIterator(const QByteArray& prefix, qlonglong value, PostingDB::Comparator com) const;
     PostingIterator* postingCompIterator(const QByteArray& prefix, double value, PostingDB::Comparator com) const;
@@ -85,6 +126,14 @@ public:
     void abort();
     void reset(TransactionType type);
 
+    /**
+     * Whether a database transaction is open, which has to be committed
+     * or aborted
+     */
+    bool isActive() const {
+        return m_txn != nullptr;
+    }
+
     //
     // Write Methods
     //
@@ -102,9 +151,43 @@ public:
     }
 
     void replaceDocument(const Document& doc, DocumentOperations operations);
-    void setPhaseOne(quint64 id);
+    /**
+     * Queues \p id for content indexing with \p priority, see
+     * Document::setContentIndexingPriority()
+     */
+    void setPhaseOne(quint64 id, quint32 priority);
     void removePhaseOne(quint64 id);
 
+    /**
+     * Sets the hash of the contents of \p id, an empty \p hash removes it
+     */
+    void setDocumentContentHash(quint64 id, const QByteArray& hash);
+
+    void setFolderFingerprint(quint64 id, const FolderFingerprintDB::Fingerprint& fingerprint);
+
+    /**
+     * Limits the memory of the pending posting list changes, see
+     * WriteTransaction::setMemoryBudget(). The budget is kept when the
+     * transaction is reset.
+     */
+    void setMemoryBudget(qint64 bytes);
+
+    /**
+     * Collect the terms of all documents added with this transaction in
+     * \p loader, see WriteTransaction::setBulkLoader(). The loader is kept
+     * when the transaction is reset.
+     */
+    void setBulkLoader(BulkLoader* loader);
+
+    /**
+     * Writes the terms collected by the bulk loader, and stops using it.
+     * The terms are committed in parts, the last part is left to commit.
+     * If it fails, the parts already committed remain in the index. When
+     * committing a part or starting the next transaction fails, no
+     * transaction is left to commit or abort, see isActive().
+     */
+    bool finishBulkLoad();
+
     // Debugging
     void checkFsTree();
     void checkTermsDbinPostingDb();
@@ -112,12 +195,14 @@ public:
 
 private:
     Transaction(const Transaction& rhs) = delete;
-    void init(TransactionType type);
+    bool init(TransactionType type);
 
     const DatabaseDbis& m_dbis;
     MDB_txn *m_txn = nullptr;
     MDB_env *m_env = nullptr;
     std::unique_ptr<WriteTransaction> m_writeTrans;
+    BulkLoader* m_bulkLoader = nullptr;
+    qint64 m_memoryBudget = 0;
 
     friend class DatabaseSanitizerImpl;
     friend class DBState; // for testing
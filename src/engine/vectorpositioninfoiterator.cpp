@@ -37,6 +37,35 @@ quint64 VectorPositionInfoIterator::docId() const
     return m_vector[m_pos].docId;
 }
 
+quint64 VectorPositionInfoIterator::estimatedSize() const
+{
+    return m_vector.size();
+}
+
+quint64 VectorPositionInfoIterator::skipTo(quint64 id)
+{
+    if (m_pos >= m_vector.size()) {
+        return 0;
+    }
+
+    const quint64 currentId = docId();
+    if (currentId >= id) {
+        return currentId;
+    }
+
+    const auto begin = m_vector.cbegin();
+    const auto it = gallopingLowerBound(begin + std::max(m_pos, 0), m_vector.cend(), id,
+        [](const PositionInfo& info, quint64 docId) { return info.docId < docId; });
+    if (it == m_vector.cend()) {
+        m_pos = m_vector.size();
+        m_vector.clear();
+        return 0;
+    }
+
+    m_pos = it - begin;
+    return it->docId;
+}
+
 QVector<uint> VectorPositionInfoIterator::positions()
 {
     if (m_pos < 0 || m_pos >= m_vector.size()) {
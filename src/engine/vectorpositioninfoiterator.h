@@ -8,19 +8,21 @@
 #ifndef BALOO_VECTORPOSITIONINFOITERATOR_H
 #define BALOO_VECTORPOSITIONINFOITERATOR_H
 
-#include "postingiterator.h"
+#include "positioninfoiterator.h"
 #include "positiondb.h"
 
 namespace Baloo {
 
-class BALOO_ENGINE_EXPORT VectorPositionInfoIterator : public PostingIterator
+class BALOO_ENGINE_EXPORT VectorPositionInfoIterator : public PositionInfoIterator
 {
 public:
     explicit VectorPositionInfoIterator(const QVector<PositionInfo>& vector);
 
     quint64 docId() const override;
     quint64 next() override;
-    QVector<uint> positions();
+    quint64 skipTo(quint64 docId) override;
+    quint64 estimatedSize() const override;
+    QVector<uint> positions() override;
 
 private:
     QVector<PositionInfo> m_vector;
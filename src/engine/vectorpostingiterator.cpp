@@ -35,3 +35,31 @@ quint64 VectorPostingIterator::next()
     m_pos++;
     return m_values[m_pos];
 }
+
+quint64 VectorPostingIterator::estimatedSize() const
+{
+    return m_values.size();
+}
+
+quint64 VectorPostingIterator::skipTo(quint64 id)
+{
+    if (m_pos >= m_values.size()) {
+        return 0;
+    }
+
+    const quint64 currentId = docId();
+    if (currentId >= id) {
+        return currentId;
+    }
+
+    const auto begin = m_values.cbegin();
+    const auto it = gallopingLowerBound(begin + std::max(m_pos, 0), m_values.cend(), id);
+    if (it == m_values.cend()) {
+        m_pos = m_values.size();
+        m_values.clear();
+        return 0;
+    }
+
+    m_pos = it - begin;
+    return *it;
+}
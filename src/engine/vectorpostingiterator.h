@@ -20,6 +20,8 @@ public:
 
     quint64 docId() const override;
     quint64 next() override;
+    quint64 skipTo(quint64 docId) override;
+    quint64 estimatedSize() const override;
 
 private:
     QVector<quint64> m_values;
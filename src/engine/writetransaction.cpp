@@ -7,15 +7,22 @@
 
 #include "writetransaction.h"
 #include "transaction.h"
+#include "bulkloader.h"
 
 #include "postingdb.h"
 #include "documentdb.h"
 #include "documentiddb.h"
+#include "contentindexingqueuedb.h"
+#include "contenthashdb.h"
+#include "folderfingerprintdb.h"
 #include "positiondb.h"
 #include "documenttimedb.h"
 #include "documentdatadb.h"
 #include "mtimedb.h"
 #include "idutils.h"
+#include "enginedebug.h"
+
+#include <algorithm>
 
 using namespace Baloo;
 
@@ -29,6 +36,7 @@ void WriteTransaction::addDocument(const Document& doc)
     DocumentTimeDB docTimeDB(m_dbis.docTimeDbi, m_txn);
     DocumentDataDB docDataDB(m_dbis.docDataDbi, m_txn);
     DocumentIdDB contentIndexingDB(m_dbis.contentIndexingDbi, m_txn);
+    ContentIndexingQueueDB queueDB(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
     MTimeDB mtimeDB(m_dbis.mtimeDbi, m_txn);
     DocumentUrlDB docUrlDB(m_dbis.idTreeDbi, m_dbis.idFilenameDbi, m_txn);
 
@@ -57,22 +65,26 @@ void WriteTransaction::addDocument(const Document& doc)
         }
     }
 
-    QVector<QByteArray> docTerms = addTerms(id, doc.m_terms);
-    Q_ASSERT(!docTerms.empty());
-    documentTermsDB.put(id, docTerms);
+    if (m_bulkLoader) {
+        m_bulkLoader->addDocument(doc);
+    } else {
+        QVector<QByteArray> docTerms = addTerms(id, doc.m_terms);
+        Q_ASSERT(!docTerms.empty());
+        documentTermsDB.put(id, docTerms);
 
-    QVector<QByteArray> docXattrTerms = addTerms(id, doc.m_xattrTerms);
-    if (!docXattrTerms.isEmpty()) {
-        documentXattrTermsDB.put(id, docXattrTerms);
-    }
+        QVector<QByteArray> docXattrTerms = addTerms(id, doc.m_xattrTerms);
+        if (!docXattrTerms.isEmpty()) {
+            documentXattrTermsDB.put(id, docXattrTerms);
+        }
 
-    QVector<QByteArray> docFileNameTerms = addTerms(id, doc.m_fileNameTerms);
-    if (!docFileNameTerms.isEmpty()) {
-        documentFileNameTermsDB.put(id, docFileNameTerms);
+        QVector<QByteArray> docFileNameTerms = addTerms(id, doc.m_fileNameTerms);
+        if (!docFileNameTerms.isEmpty()) {
+            documentFileNameTermsDB.put(id, docFileNameTerms);
+        }
     }
 
     if (doc.contentIndexing()) {
-        contentIndexingDB.put(doc.id());
+        queueDB.put(doc.id(), doc.contentIndexingPriority());
     }
 
     DocumentTimeDB::TimeInfo info;
@@ -85,29 +97,51 @@ void WriteTransaction::addDocument(const Document& doc)
     if (!doc.m_data.isEmpty()) {
         docDataDB.put(id, doc.m_data);
     }
+
+    flushIfOverBudget();
 }
 
-QVector<QByteArray> WriteTransaction::addTerms(quint64 id, const QMap<QByteArray, Document::TermData>& terms)
+QVector<QByteArray> WriteTransaction::addTerms(quint64 id, const TermStore& terms)
 {
     QVector<QByteArray> termList;
     termList.reserve(terms.size());
     m_pendingOperations.reserve(m_pendingOperations.size() + terms.size());
 
-    for (auto it = terms.cbegin(), end = terms.cend(); it != end; ++it) {
-        const QByteArray& term = it.key();
-        termList.append(term);
+    for (int i = 0; i < terms.size(); ++i) {
+        const TermStore::Entry entry = terms.at(i);
 
         Operation op;
         op.type = AddId;
         op.data.docId = id;
-        op.data.positions = it.value().positions;
+        op.data.positions = entry.positions();
 
-        m_pendingOperations[term].append(op);
+        termList.append(addOperation(entry.term(), std::move(op)));
     }
 
     return termList;
 }
 
+QByteArray WriteTransaction::addOperation(QByteArrayView term, Operation op)
+{
+    // The lookup does not copy the term
+    auto it = m_pendingOperations.find(QByteArray::fromRawData(term.data(), term.size()));
+    if (it == m_pendingOperations.end()) {
+        it = m_pendingOperations.insert(term.toByteArray(), QVector<Operation>());
+        m_pendingOperationsSize += PendingTermOverhead + term.size();
+    }
+    m_pendingOperationsSize += sizeof(Operation) + op.data.positions.size() * sizeof(uint);
+    it->append(std::move(op));
+    return it.key();
+}
+
+void WriteTransaction::flushIfOverBudget()
+{
+    if (m_memoryBudget > 0 && m_pendingOperationsSize > m_memoryBudget) {
+        qCDebug(ENGINE) << "Flushing" << m_pendingOperations.size() << "terms," << m_pendingOperationsSize << "bytes";
+        commit();
+    }
+}
+
 void WriteTransaction::removeDocument(quint64 id)
 {
     DocumentDB documentTermsDB(m_dbis.docTermsDbi, m_txn);
@@ -115,8 +149,10 @@ void WriteTransaction::removeDocument(quint64 id)
     DocumentDB documentFileNameTermsDB(m_dbis.docFilenameTermsDbi, m_txn);
     DocumentTimeDB docTimeDB(m_dbis.docTimeDbi, m_txn);
     DocumentDataDB docDataDB(m_dbis.docDataDbi, m_txn);
-    DocumentIdDB contentIndexingDB(m_dbis.contentIndexingDbi, m_txn);
+    ContentIndexingQueueDB queueDB(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
     DocumentIdDB failedIndexingDB(m_dbis.failedIdDbi, m_txn);
+    ContentHashDB contentHashDB(m_dbis.contentHashDbi, m_dbis.contentHashIdDbi, m_txn);
+    FolderFingerprintDB folderFingerprintDB(m_dbis.folderFingerprintDbi, m_txn);
     MTimeDB mtimeDB(m_dbis.mtimeDbi, m_txn);
     DocumentUrlDB docUrlDB(m_dbis.idTreeDbi, m_dbis.idFilenameDbi, m_txn);
 
@@ -132,14 +168,18 @@ void WriteTransaction::removeDocument(quint64 id)
 
     docUrlDB.del(id);
 
-    contentIndexingDB.del(id);
+    queueDB.del(id);
     failedIndexingDB.del(id);
+    contentHashDB.del(id);
+    folderFingerprintDB.del(id);
 
     DocumentTimeDB::TimeInfo info = docTimeDB.get(id);
     docTimeDB.del(id);
     mtimeDB.del(info.mTime, id);
 
     docDataDB.del(id);
+
+    flushIfOverBudget();
 }
 
 void WriteTransaction::removeTerms(quint64 id, const QVector<QByteArray>& terms)
@@ -149,7 +189,7 @@ void WriteTransaction::removeTerms(quint64 id, const QVector<QByteArray>& terms)
         op.type = RemoveId;
         op.data.docId = id;
 
-        m_pendingOperations[term].append(op);
+        addOperation(term, op);
     }
 }
 
@@ -194,7 +234,7 @@ void WriteTransaction::replaceDocument(const Document& doc, DocumentOperations o
     DocumentDB documentFileNameTermsDB(m_dbis.docFilenameTermsDbi, m_txn);
     DocumentTimeDB docTimeDB(m_dbis.docTimeDbi, m_txn);
     DocumentDataDB docDataDB(m_dbis.docDataDbi, m_txn);
-    DocumentIdDB contentIndexingDB(m_dbis.contentIndexingDbi, m_txn);
+    ContentIndexingQueueDB queueDB(m_dbis.contentIndexingDbi, m_dbis.contentIndexingQueueDbi, m_txn);
     MTimeDB mtimeDB(m_dbis.mtimeDbi, m_txn);
     DocumentUrlDB docUrlDB(m_dbis.idTreeDbi, m_dbis.idFilenameDbi, m_txn);
 
@@ -237,7 +277,7 @@ void WriteTransaction::replaceDocument(const Document& doc, DocumentOperations o
     }
 
     if (doc.contentIndexing()) {
-        contentIndexingDB.put(doc.id());
+        queueDB.put(doc.id(), doc.contentIndexingPriority());
     }
 
     if (operations & DocumentTime) {
@@ -266,10 +306,12 @@ void WriteTransaction::replaceDocument(const Document& doc, DocumentOperations o
         auto newname = url.mid(pos + 1);
         docUrlDB.updateUrl(doc.id(), doc.parentId(), newname);
     }
+
+    flushIfOverBudget();
 }
 
 QVector< QByteArray > WriteTransaction::replaceTerms(quint64 id, const QVector<QByteArray>& prevTerms,
-                                                     const QMap<QByteArray, Document::TermData>& terms)
+                                                     const TermStore& terms)
 {
     m_pendingOperations.reserve(m_pendingOperations.size() + prevTerms.size() + terms.size());
     for (const QByteArray& term : prevTerms) {
@@ -277,67 +319,184 @@ QVector< QByteArray > WriteTransaction::replaceTerms(quint64 id, const QVector<Q
         op.type = RemoveId;
         op.data.docId = id;
 
-        m_pendingOperations[term].append(op);
+        addOperation(term, op);
     }
 
     return addTerms(id, terms);
 }
 
-void WriteTransaction::commit()
+namespace {
+/*
+ * The net effect of the pending operations of a term on one document
+ */
+struct IdChange {
+    enum Type {
+        Remove,
+        // Add the id, keeping the existing entry if there is one
+        Add,
+        // Add the id, replacing the existing entry
+        Replace,
+    };
+
+    Type type;
+    const PositionInfo* data;
+
+    quint64 docId() const {
+        return data->docId;
+    }
+};
+}
+
+/*
+ * Collapses the operations into one change per id, sorted by id. The
+ * operations are applied in order, and adding an id which is already in
+ * the list has no effect, unless it has been removed before.
+ */
+static QVector<IdChange> collapseOperations(const QVector<WriteTransaction::Operation>& operations)
 {
-    PostingDB postingDB(m_dbis.postingDbi, m_txn);
-    PositionDB positionDB(m_dbis.positionDBi, m_txn);
+    QVector<const WriteTransaction::Operation*> sorted;
+    sorted.reserve(operations.size());
+    for (const WriteTransaction::Operation& op : operations) {
+        sorted << &op;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const WriteTransaction::Operation* lhs, const WriteTransaction::Operation* rhs) {
+        return lhs->data.docId < rhs->data.docId;
+    });
+
+    QVector<IdChange> changes;
+    changes.reserve(sorted.size());
+    for (const WriteTransaction::Operation* op : std::as_const(sorted)) {
+        const bool sameId = !changes.isEmpty() && changes.last().docId() == op->data.docId;
+
+        if (op->type == WriteTransaction::RemoveId) {
+            if (sameId) {
+                changes.last() = {IdChange::Remove, &op->data};
+            } else {
+                changes.append({IdChange::Remove, &op->data});
+            }
+        } else if (!sameId) {
+            changes.append({IdChange::Add, &op->data});
+        } else if (changes.last().type == IdChange::Remove) {
+            changes.last() = {IdChange::Replace, &op->data};
+        }
+    }
+
+    return changes;
+}
+
+static quint64 docIdOf(quint64 id)
+{
+    return id;
+}
+
+static quint64 docIdOf(const PositionInfo& info)
+{
+    return info.docId;
+}
 
-    QHashIterator<QByteArray, QVector<Operation> > iter(m_pendingOperations);
-    while (iter.hasNext()) {
-        iter.next();
+static void appendChange(PostingList& list, const IdChange& change)
+{
+    list.append(change.docId());
+}
 
-        const QByteArray& term = iter.key();
-        const QVector<Operation> operations = iter.value();
+static void appendChange(QVector<PositionInfo>& list, const IdChange& change)
+{
+    list.append(*change.data);
+}
 
-        PostingList list = postingDB.get(term);
+/*
+ * Applies the sorted changes to the sorted list in a single pass
+ */
+template<typename List>
+static List mergeChanges(const List& list, QVector<IdChange>::const_iterator begin, QVector<IdChange>::const_iterator end)
+{
+    List result;
+    result.reserve(list.size() + (end - begin));
+
+    auto it = list.cbegin();
+    for (auto change = begin; change != end; ++change) {
+        const quint64 id = change->docId();
+        while (it != list.cend() && docIdOf(*it) < id) {
+            result.append(*it);
+            ++it;
+        }
 
-        bool fetchedPositionList = false;
-        QVector<PositionInfo> positionList;
+        const bool exists = it != list.cend() && docIdOf(*it) == id;
+        if (change->type == IdChange::Add && exists) {
+            result.append(*it);
+        } else if (change->type != IdChange::Remove) {
+            appendChange(result, *change);
+        }
 
-        for (const Operation& op : operations) {
-            quint64 id = op.data.docId;
-
-            if (op.type == AddId) {
-                sortedIdInsert(list, id);
-
-                if (!op.data.positions.isEmpty()) {
-                    if (!fetchedPositionList) {
-                        positionList = positionDB.get(term);
-                        fetchedPositionList = true;
-                    }
-                    sortedIdInsert(positionList, op.data);
-                }
-            }
-            else {
-                sortedIdRemove(list, id);
-                if (!fetchedPositionList) {
-                    positionList = positionDB.get(term);
-                    fetchedPositionList = true;
-                }
-                sortedIdRemove(positionList, PositionInfo(id));
-            }
+        if (exists) {
+            ++it;
         }
+    }
+    for (; it != list.cend(); ++it) {
+        result.append(*it);
+    }
 
-        if (!list.isEmpty()) {
-            postingDB.put(term, list);
-        } else {
-            postingDB.del(term);
+    return result;
+}
+
+/*
+ * Applies the changes on a chunked posting or position list. Only the
+ * chunks covering the ids of the changes are read and written back.
+ */
+template<typename DB>
+static void applyToChunks(DB& db, const QByteArray& term, const QVector<IdChange>& changes)
+{
+    QVector<quint64> chunks = db.chunks(term);
+    if (chunks.isEmpty()) {
+        chunks << 0;
+    }
+
+    // Back to front, as emptying the first chunk moves the second one in its place
+    auto end = changes.cend();
+    for (int i = chunks.size() - 1; i >= 0 && end != changes.cbegin(); i--) {
+        auto begin = std::lower_bound(changes.cbegin(), end, chunks[i], [](const IdChange& change, quint64 id) {
+            return change.docId() < id;
+        });
+        if (begin == end) {
+            continue;
         }
 
-        if (fetchedPositionList) {
-            if (!positionList.isEmpty()) {
-                positionDB.put(term, positionList);
-            } else {
-                positionDB.del(term);
+        const auto list = db.getChunk(term, chunks[i]);
+        db.putChunk(term, chunks[i], mergeChanges(list, begin, end));
+        end = begin;
+    }
+}
+
+void WriteTransaction::commit()
+{
+    PostingDB postingDB(m_dbis.postingDbi, m_txn);
+    PositionDB positionDB(m_dbis.positionDBi, m_txn);
+
+    /*
+     * Process the terms in key order. PostingDB and PositionDB access the
+     * terms through a single cursor each, which then moves mostly forward
+     * through neighbouring pages instead of jumping around the whole tree.
+     */
+    QVector<QByteArray> terms = m_pendingOperations.keys();
+    std::sort(terms.begin(), terms.end());
+
+    for (const QByteArray& term : std::as_const(terms)) {
+        const QVector<Operation> operations = m_pendingOperations.value(term);
+
+        applyToChunks(postingDB, term, collapseOperations(operations));
+
+        // Only documents with positions for this term are in the position list
+        QVector<Operation> positionOperations;
+        for (const Operation& op : operations) {
+            if (op.type == RemoveId || !op.data.positions.isEmpty()) {
+                positionOperations.append(op);
             }
         }
+        if (!positionOperations.isEmpty()) {
+            applyToChunks(positionDB, term, collapseOperations(positionOperations));
+        }
     }
 
     m_pendingOperations.clear();
+    m_pendingOperationsSize = 0;
 }
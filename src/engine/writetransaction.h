@@ -17,6 +17,8 @@
 
 namespace Baloo {
 
+class BulkLoader;
+
 class BALOO_ENGINE_EXPORT WriteTransaction
 {
 public:
@@ -26,6 +28,18 @@ public:
     {}
 
     void addDocument(const Document& doc);
+
+    /**
+     * Sends the terms of documents added from now on to \p loader, instead
+     * of writing them to the term databases. Only valid for an empty index,
+     * as the documents can't be replaced or removed until the loader is
+     * finished.
+     */
+    void setBulkLoader(BulkLoader* loader)
+    {
+        m_bulkLoader = loader;
+    }
+
     void removeDocument(quint64 id);
 
     /**
@@ -47,8 +61,31 @@ public:
     bool removeRecursively(quint64 parentId, const std::function<bool(quint64)> &shouldDelete);
 
     void replaceDocument(const Document& doc, DocumentOperations operations);
+
+    /**
+     * Writes the pending changes of the posting and position lists.
+     */
     void commit();
 
+    /**
+     * Limits the memory used by the pending changes of the posting and
+     * position lists. Once the estimated size exceeds \p bytes after a
+     * document has been added, replaced or removed, the changes are written
+     * to the databases. A budget of 0 keeps all changes until commit().
+     */
+    void setMemoryBudget(qint64 bytes)
+    {
+        m_memoryBudget = bytes;
+    }
+
+    /**
+     * Estimated memory used by the pending changes, in bytes
+     */
+    qint64 pendingOperationsSize() const
+    {
+        return m_pendingOperationsSize;
+    }
+
     enum OperationType {
         AddId,
         RemoveId,
@@ -63,15 +100,28 @@ private:
      * Adds an 'addId' operation to the pending queue for each term.
      * Returns the list of all the terms.
      */
-    BALOO_ENGINE_NO_EXPORT QVector<QByteArray> addTerms(quint64 id, const QMap<QByteArray, Document::TermData>& terms);
+    BALOO_ENGINE_NO_EXPORT QVector<QByteArray> addTerms(quint64 id, const TermStore& terms);
     BALOO_ENGINE_NO_EXPORT QVector<QByteArray> replaceTerms(quint64 id, const QVector<QByteArray>& prevTerms,
-                                     const QMap<QByteArray, Document::TermData>& terms);
+                                     const TermStore& terms);
     BALOO_ENGINE_NO_EXPORT void removeTerms(quint64 id, const QVector<QByteArray>& terms);
 
+    /*
+     * Returns the term as stored in the pending operations, the key is
+     * shared with it instead of allocating another copy.
+     */
+    BALOO_ENGINE_NO_EXPORT QByteArray addOperation(QByteArrayView term, Operation op);
+    BALOO_ENGINE_NO_EXPORT void flushIfOverBudget();
+
+    // Rough per term cost of the hash node, key and operation vector
+    static constexpr int PendingTermOverhead = 64;
+
     QHash<QByteArray, QVector<Operation> > m_pendingOperations;
+    qint64 m_pendingOperationsSize = 0;
+    qint64 m_memoryBudget = 0;
 
     MDB_txn* m_txn;
     DatabaseDbis m_dbis;
+    BulkLoader* m_bulkLoader = nullptr;
 };
 }
 
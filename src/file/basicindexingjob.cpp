@@ -8,6 +8,7 @@
 #include "basicindexingjob.h"
 #include "termgenerator.h"
 #include "idutils.h"
+#include "statcache.h"
 
 #include <QStringList>
 #include <QFile>
@@ -15,6 +16,9 @@
 #include <KFileMetaData/Types>
 #include <KFileMetaData/UserMetaData>
 
+#include <algorithm>
+#include <limits>
+
 using namespace Baloo;
 
 BasicIndexingJob::BasicIndexingJob(const QString& filePath, const QString& mimetype,
@@ -196,12 +200,50 @@ QVector<KFileMetaData::Type::Type> typesForMimeType(const QString& mimeType)
 
     return types;
 }
+
 } // namespace
 
 BasicIndexingJob::~BasicIndexingJob()
 {
 }
 
+void BasicIndexingJob::setStatBuf(const QT_STATBUF& statBuf)
+{
+    m_statBuf = statBuf;
+    m_hasStatBuf = true;
+}
+
+void BasicIndexingJob::setParentId(quint64 parentId)
+{
+    m_parentId = parentId;
+}
+
+void BasicIndexingJob::setStatCache(StatCache* cache)
+{
+    m_statCache = cache;
+}
+
+// Files are content indexed by age, recently modified files first. Large
+// files and files in hidden folders are treated as older, so many small
+// files do not wait for a single large one.
+quint32 BasicIndexingJob::contentIndexingPriority(const QByteArray& url, const QT_STATBUF& statBuf)
+{
+    constexpr quint64 day = 24 * 60 * 60;
+
+    quint64 priority = Document::defaultContentIndexingPriority(statBuf.st_mtime);
+
+    // One day for every factor of 16 above 1 MiB
+    for (quint64 size = quint64(statBuf.st_size) >> 20; size > 0; size >>= 4) {
+        priority += day;
+    }
+
+    if (url.contains("/.")) {
+        priority += 30 * day;
+    }
+
+    return std::min<quint64>(priority, std::numeric_limits<quint32>::max());
+}
+
 bool BasicIndexingJob::index()
 {
     const QByteArray url = QFile::encodeName(m_filePath);
@@ -211,14 +253,28 @@ bool BasicIndexingJob::index()
     const QByteArray filePath = url.left(lastSlash);
 
     QT_STATBUF statBuf;
-    if (filePathToStat(filePath, statBuf) != 0) {
-        return false;
+    quint64 parentId = m_parentId;
+    if (!parentId) {
+        if (m_statCache) {
+            parentId = m_statCache->folderId(filePath);
+        } else if (filePathToStat(filePath, statBuf) == 0) {
+            parentId = statBufToId(statBuf);
+        }
+        if (!parentId) {
+            return false;
+        }
     }
 
     Document doc;
-    doc.setParentId(statBufToId(statBuf));
+    doc.setParentId(parentId);
 
-    if (filePathToStat(url, statBuf) != 0) {
+    if (m_hasStatBuf) {
+        statBuf = m_statBuf;
+    } else if (m_statCache) {
+        if (m_statCache->stat(url, statBuf) != 0) {
+            return false;
+        }
+    } else if (filePathToStat(url, statBuf) != 0) {
         return false;
     }
     doc.setId(statBufToId(statBuf));
@@ -245,6 +301,7 @@ bool BasicIndexingJob::index()
         if (m_indexingLevel == MarkForContentIndexing) {
             doc.setContentIndexing(true);
         }
+        doc.setContentIndexingPriority(contentIndexingPriority(url, statBuf));
         // Types
         const QVector<KFileMetaData::Type::Type> tList = typesForMimeType(m_mimetype);
         for (KFileMetaData::Type::Type type : tList) {
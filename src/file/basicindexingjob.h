@@ -10,8 +10,12 @@
 
 #include "document.h"
 
+#include <qplatformdefs.h>
+
 namespace Baloo {
 
+class StatCache;
+
 class BasicIndexingJob
 {
 public:
@@ -24,8 +28,32 @@ public:
                      IndexingLevel level = MarkForContentIndexing);
     ~BasicIndexingJob();
 
+    /**
+     * Uses \p statBuf instead of stat'ing the file again, it has to be
+     * from filePathToStat() or FilteredDirIterator::statBuf()
+     */
+    void setStatBuf(const QT_STATBUF& statBuf);
+
+    /**
+     * Uses \p parentId as the id of the parent folder instead of
+     * stat'ing it, 0 if it is not known
+     */
+    void setParentId(quint64 parentId);
+
+    /**
+     * Stats the file and its parent folder through \p cache
+     */
+    void setStatCache(StatCache* cache);
+
     bool index();
 
+    /**
+     * The content indexing priority of a file, see
+     * Document::setContentIndexingPriority(). All files queued for content
+     * indexing get their priority from here, so they are ordered alike.
+     */
+    static quint32 contentIndexingPriority(const QByteArray& url, const QT_STATBUF& statBuf);
+
     Document document() { return m_doc; }
 
 private:
@@ -33,6 +61,11 @@ private:
     QString m_mimetype;
     IndexingLevel m_indexingLevel;
 
+    QT_STATBUF m_statBuf;
+    bool m_hasStatBuf = false;
+    quint64 m_parentId = 0;
+    StatCache* m_statCache = nullptr;
+
     Document m_doc;
 
     friend class BasicIndexingJobTest;
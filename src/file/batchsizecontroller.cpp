@@ -0,0 +1,46 @@
+/*
+    This file is part of the KDE Baloo Project
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "batchsizecontroller.h"
+
+#include <algorithm>
+
+using namespace Baloo;
+
+BatchSizeController::BatchSizeController(uint initialBatchSize)
+    : m_batchSize(qBound(MinBatchSize, initialBatchSize, MaxBatchSize))
+{
+}
+
+uint BatchSizeController::batchSize() const
+{
+    return m_batchSize;
+}
+
+void BatchSizeController::handleBatch(uint files, uint time, uint commitTime, qint64 memoryGrowth)
+{
+    if (files == 0) {
+        return;
+    }
+
+    const double rate = double(files) / std::max(time, 1u);
+    m_rate = (m_rate > 0) ? (m_rate + rate) / 2 : rate;
+
+    double target = m_rate * TargetTime;
+    if (commitTime > TargetCommitTime) {
+        target = std::min(target, double(files) * TargetCommitTime / commitTime);
+    }
+    if (memoryGrowth > MemoryGrowthLimit) {
+        target = std::min(target, m_batchSize / 2.0);
+    }
+
+    // Change the size at most by a factor of two per batch, single slow
+    // files would otherwise make it jump around
+    target = qBound(m_batchSize / 2.0, target, m_batchSize * 2.0);
+
+    m_batchSize = qBound(MinBatchSize, static_cast<uint>(target), MaxBatchSize);
+}
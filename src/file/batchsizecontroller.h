@@ -0,0 +1,56 @@
+/*
+    This file is part of the KDE Baloo Project
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_BATCHSIZECONTROLLER_H
+#define BALOO_BATCHSIZECONTROLLER_H
+
+#include <QtGlobal>
+
+namespace Baloo {
+
+/**
+ * Adapts the number of files the FileContentIndexer fetches per batch.
+ * The batch size follows the measured throughput, so a batch takes about
+ * TargetTime, and shrinks when committing takes too long or the extractors
+ * grow too much during a batch. Batches of large documents get small,
+ * batches of many small files get large.
+ */
+class BatchSizeController
+{
+public:
+    explicit BatchSizeController(uint initialBatchSize);
+
+    uint batchSize() const;
+
+    /**
+     * Updates the batch size after a batch of \p files files
+     *
+     * \p time is the duration of the whole batch in msecs, \p commitTime the
+     * part of it spent writing the results. \p memoryGrowth is the largest
+     * growth of the resident size of an extractor process during the batch
+     * in bytes, or 0 if unknown.
+     */
+    void handleBatch(uint files, uint time, uint commitTime, qint64 memoryGrowth);
+
+    static constexpr uint MinBatchSize = 1;
+    static constexpr uint MaxBatchSize = 400;
+    static constexpr uint TargetTime = 3000;
+    static constexpr uint TargetCommitTime = 500;
+    static constexpr qint64 MemoryGrowthLimit = 128 * 1024 * 1024;
+    /// Extractor processes above this resident size are restarted
+    static constexpr qint64 MemoryLimit = 512 * 1024 * 1024;
+
+private:
+    uint m_batchSize;
+
+    // Smoothed throughput in files per msec
+    double m_rate = 0;
+};
+
+}
+
+#endif //BALOO_BATCHSIZECONTROLLER_H
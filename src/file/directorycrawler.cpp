@@ -0,0 +1,261 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "directorycrawler.h"
+#include "filtereddiriterator.h"
+#include "idutils.h"
+
+#include <QDateTime>
+#include <QThread>
+
+using namespace Baloo;
+
+DirectoryCrawler::DirectoryCrawler(const FileIndexerConfig* config, const QString& folder, uint threadCount,
+                                   const WorkerFactory& factory)
+    : m_config(config)
+    , m_factory(factory)
+    , m_pendingFolders(1)
+    , m_idleWorkers(0)
+    , m_stopped(false)
+    , m_runningWorkers(qMax(threadCount, 1u))
+{
+    for (uint i = 0; i < m_runningWorkers; i++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_queues[0]->folders.push_back({folder, {}, true});
+
+    for (uint i = 0; i < m_queues.size(); i++) {
+        std::unique_ptr<QThread> thread(QThread::create([this, i] {
+            runWorker(i);
+        }));
+        thread->setObjectName(QStringLiteral("DirectoryCrawler %1").arg(i));
+        thread->start();
+        m_threads.push_back(std::move(thread));
+    }
+}
+
+DirectoryCrawler::~DirectoryCrawler()
+{
+    m_stopped = true;
+    {
+        QMutexLocker lock(&m_idleMutex);
+        m_folderAvailable.wakeAll();
+    }
+    {
+        QMutexLocker lock(&m_itemMutex);
+        m_itemSpace.wakeAll();
+    }
+    for (const auto& thread : m_threads) {
+        thread->wait();
+    }
+}
+
+void DirectoryCrawler::runWorker(uint index)
+{
+    const Worker worker = m_factory();
+
+    Folder folder;
+    while (takeFolder(index, folder)) {
+        // The root folder is only stat'ed by its own listing
+        FolderFingerprintDB::Fingerprint stored;
+        const bool quick = !folder.root && worker.unchanged && worker.unchanged(folder.statBuf, stored);
+        listFolder(index, worker, folder, quick, stored);
+        finishFolder();
+    }
+
+    QMutexLocker lock(&m_itemMutex);
+    m_runningWorkers--;
+    m_itemAvailable.wakeAll();
+}
+
+void DirectoryCrawler::listFolder(uint index, const Worker& worker, const Folder& folder, bool quick,
+                                  const FolderFingerprintDB::Fingerprint& stored)
+{
+    // A change in the second of the listing may leave the times of the
+    // folder as they are, such a folder gets no fingerprint
+    const qint64 listingTime = QDateTime::currentSecsSinceEpoch();
+
+    // The root folder is returned by its own iterator, the other
+    // folders have been returned by the iterator of their parent
+    FilteredDirIterator it(m_config, folder.path, FilteredDirIterator::FilesAndDirs,
+                           folder.root ? FilteredDirIterator::NotRecursive : FilteredDirIterator::ChildrenOnly);
+    it.setFileStatSkipped(quick);
+
+    // The entries of a quick listing are held back until the entry
+    // count confirms the fingerprint
+    std::vector<Folder> subFolders;
+    std::vector<Item> items;
+
+    QT_STATBUF folderStat = folder.statBuf;
+    bool listed = !folder.root;
+    bool folderItem = folder.root;
+    while (!m_stopped && !it.next().isEmpty()) {
+        if (folderItem) {
+            folderStat = it.statBuf();
+            listed = true;
+        }
+        const bool subFolder = !folderItem && it.isDir();
+        folderItem = false;
+
+        Item item;
+        if (worker.process(it, item)) {
+            if (quick) {
+                items.push_back(std::move(item));
+            } else if (!pushItem(std::move(item))) {
+                return;
+            }
+        }
+
+        // Only after the item of the folder, so the items of its children,
+        // listed by any worker, always follow it
+        if (subFolder) {
+            if (quick) {
+                subFolders.push_back({it.filePath(), it.statBuf(), false});
+            } else {
+                pushFolder(index, it.filePath(), it.statBuf());
+            }
+        }
+    }
+    if (m_stopped || !listed) {
+        return;
+    }
+
+    FolderFingerprintDB::Fingerprint fingerprint;
+    fingerprint.mTime = folderStat.st_mtime;
+    fingerprint.cTime = folderStat.st_ctime;
+    fingerprint.entryCount = it.entryCount();
+
+    if (quick) {
+        if (!(fingerprint == stored)) {
+            // Changed in the second of the stored times
+            listFolder(index, worker, folder, false, stored);
+            return;
+        }
+        for (Item& item : items) {
+            if (!pushItem(std::move(item))) {
+                return;
+            }
+        }
+        for (const Folder& subFolder : subFolders) {
+            pushFolder(index, subFolder.path, subFolder.statBuf);
+        }
+        return;
+    }
+
+    if (folderStat.st_mtime < listingTime && folderStat.st_ctime < listingTime) {
+        Item item;
+        item.folderId = statBufToId(folderStat);
+        item.fingerprint = fingerprint;
+        pushItem(std::move(item));
+    }
+}
+
+bool DirectoryCrawler::tryTakeFolder(uint index, Folder& folder)
+{
+    // The newest folder of the own queue keeps the crawl depth first,
+    // so the queues stay short
+    {
+        WorkerQueue& queue = *m_queues[index];
+        QMutexLocker lock(&queue.mutex);
+        if (!queue.folders.empty()) {
+            folder = std::move(queue.folders.back());
+            queue.folders.pop_back();
+            return true;
+        }
+    }
+
+    // The oldest folder of another queue is the closest to the root,
+    // and likely has the most work below it
+    for (uint i = 1; i < m_queues.size(); i++) {
+        WorkerQueue& queue = *m_queues[(index + i) % m_queues.size()];
+        QMutexLocker lock(&queue.mutex);
+        if (!queue.folders.empty()) {
+            folder = std::move(queue.folders.front());
+            queue.folders.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DirectoryCrawler::takeFolder(uint index, Folder& folder)
+{
+    if (m_stopped) {
+        return false;
+    }
+    if (tryTakeFolder(index, folder)) {
+        return true;
+    }
+
+    QMutexLocker lock(&m_idleMutex);
+    // A folder pushed before the increment does not wake anyone, the
+    // check after it finds that folder
+    m_idleWorkers++;
+    bool found = false;
+    while (!m_stopped && m_pendingFolders > 0) {
+        if (tryTakeFolder(index, folder)) {
+            found = true;
+            break;
+        }
+        m_folderAvailable.wait(&m_idleMutex);
+    }
+    m_idleWorkers--;
+    return found;
+}
+
+void DirectoryCrawler::pushFolder(uint index, const QString& path, const QT_STATBUF& statBuf)
+{
+    m_pendingFolders++;
+    {
+        WorkerQueue& queue = *m_queues[index];
+        QMutexLocker lock(&queue.mutex);
+        queue.folders.push_back({path, statBuf, false});
+    }
+
+    if (m_idleWorkers > 0) {
+        QMutexLocker lock(&m_idleMutex);
+        m_folderAvailable.wakeOne();
+    }
+}
+
+void DirectoryCrawler::finishFolder()
+{
+    if (--m_pendingFolders == 0) {
+        QMutexLocker lock(&m_idleMutex);
+        m_folderAvailable.wakeAll();
+    }
+}
+
+bool DirectoryCrawler::pushItem(Item&& item)
+{
+    QMutexLocker lock(&m_itemMutex);
+    while (m_items.size() >= maxQueuedItems && !m_stopped) {
+        m_itemSpace.wait(&m_itemMutex);
+    }
+    if (m_stopped) {
+        return false;
+    }
+    m_items.push_back(std::move(item));
+    m_itemAvailable.wakeOne();
+    return true;
+}
+
+bool DirectoryCrawler::next(Item& item)
+{
+    QMutexLocker lock(&m_itemMutex);
+    while (m_items.empty() && m_runningWorkers > 0) {
+        m_itemAvailable.wait(&m_itemMutex);
+    }
+    if (m_items.empty()) {
+        return false;
+    }
+
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_itemSpace.wakeOne();
+    return true;
+}
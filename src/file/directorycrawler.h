@@ -0,0 +1,154 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_DIRECTORYCRAWLER_H
+#define BALOO_DIRECTORYCRAWLER_H
+
+#include "document.h"
+#include "documentoperations.h"
+#include "folderfingerprintdb.h"
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <qplatformdefs.h>
+
+class QThread;
+
+namespace Baloo {
+
+class FileIndexerConfig;
+class FilteredDirIterator;
+
+/**
+ * Crawls the files and folders to be indexed below a folder with a pool
+ * of threads, the entries are the same as the ones of a recursive
+ * FilteredDirIterator, in no particular order.
+ *
+ * Each worker lists one folder at a time, and puts the subfolders on its
+ * own queue. It takes the newest folder from its queue, an idle worker
+ * steals the oldest folder from the queue of another worker. The entries
+ * are handed to a process function on the worker thread, so the stat,
+ * xattr and database lookups run in parallel. The resulting documents
+ * are put into a bounded queue, which is drained by the one consumer
+ * calling next(), the owner of the write transaction.
+ *
+ * After the entries of a folder, its fingerprint is handed over. A folder
+ * whose stored fingerprint still matches is listed without a stat of its
+ * regular files. Its entries are held back until the entry count confirms
+ * the match, the folder is listed again with the stats otherwise.
+ */
+class DirectoryCrawler
+{
+public:
+    struct Item {
+        Document document;
+        /// The operations to replace an existing document with, none
+        /// if the document is only to be added
+        DocumentOperations operations;
+
+        /// Set for the fingerprint of a folder whose entries have all
+        /// been handed over, the document is empty then
+        quint64 folderId = 0;
+        FolderFingerprintDB::Fingerprint fingerprint;
+    };
+
+    /**
+     * Called on the worker thread for each entry of \p it, fills
+     * \p item and returns true if it is to be handed to the consumer.
+     * The regular files of an unchanged folder have no stat yet, see
+     * FilteredDirIterator::stat().
+     */
+    using ProcessFunction = std::function<bool(FilteredDirIterator& it, Item& item)>;
+
+    /**
+     * Called on the worker thread with the stat of a folder before listing
+     * it. Returns true if the folder matches its stored \p fingerprint.
+     */
+    using UnchangedFunction = std::function<bool(const QT_STATBUF& folderStat, FolderFingerprintDB::Fingerprint& fingerprint)>;
+
+    struct Worker {
+        ProcessFunction process;
+        /// Optional, all folders are listed with the stats without it
+        UnchangedFunction unchanged;
+    };
+
+    /**
+     * Called once on each worker thread, the returned functions can
+     * keep per thread state such as a read transaction
+     */
+    using WorkerFactory = std::function<Worker()>;
+
+    DirectoryCrawler(const FileIndexerConfig* config, const QString& folder, uint threadCount,
+                     const WorkerFactory& factory);
+
+    /**
+     * Stops the workers, the remaining entries are dropped
+     */
+    ~DirectoryCrawler();
+
+    DirectoryCrawler(const DirectoryCrawler&) = delete;
+    DirectoryCrawler& operator=(const DirectoryCrawler&) = delete;
+
+    /**
+     * Waits for the next item, returns false when the crawl is done
+     */
+    bool next(Item& item);
+
+    /// The number of items buffered between the workers and the consumer
+    static constexpr std::size_t maxQueuedItems = 1024;
+
+private:
+    struct Folder {
+        QString path;
+        QT_STATBUF statBuf;
+        bool root;
+    };
+    struct WorkerQueue {
+        QMutex mutex;
+        std::deque<Folder> folders;
+    };
+
+    void runWorker(uint index);
+    void listFolder(uint index, const Worker& worker, const Folder& folder, bool quick,
+                    const FolderFingerprintDB::Fingerprint& stored);
+    bool takeFolder(uint index, Folder& folder);
+    bool tryTakeFolder(uint index, Folder& folder);
+    void pushFolder(uint index, const QString& path, const QT_STATBUF& statBuf);
+    void finishFolder();
+    bool pushItem(Item&& item);
+
+    const FileIndexerConfig* m_config;
+    WorkerFactory m_factory;
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+
+    // The folders queued or being listed, the crawl is done at zero
+    std::atomic<int> m_pendingFolders;
+    std::atomic<int> m_idleWorkers;
+    std::atomic<bool> m_stopped;
+    QMutex m_idleMutex;
+    QWaitCondition m_folderAvailable;
+
+    QMutex m_itemMutex;
+    QWaitCondition m_itemAvailable;
+    QWaitCondition m_itemSpace;
+    std::deque<Item> m_items;
+    uint m_runningWorkers;
+};
+
+}
+
+#endif // BALOO_DIRECTORYCRAWLER_H
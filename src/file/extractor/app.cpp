@@ -16,7 +16,9 @@
 #include <QCoreApplication>
 
 #include <QTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QCryptographicHash>
 
 #include <KFileMetaData/Extractor>
 #include <KFileMetaData/MimeUtils>
@@ -27,13 +29,45 @@
 
 using namespace Baloo;
 
+namespace {
+// Larger files are always extracted
+constexpr qint64 MaxHashedFileSize = 64 * 1024 * 1024;
+
+// The stored hash starts with the file size as 8 byte big endian value, so
+// documents of a given size can be looked up without hashing anything
+QByteArray fileSizeKey(qint64 size)
+{
+    QByteArray key;
+    key.reserve(8);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        key.append(static_cast<char>(size >> shift));
+    }
+    return key;
+}
+
+// The mimetype is part of the hash, as the extracted terms depend on it
+QByteArray fileContentHash(const QString& url, const QString& mimetype, const QByteArray& sizeKey)
+{
+    QFile file(url);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(mimetype.toUtf8());
+    if (!hash.addData(&file)) {
+        return QByteArray();
+    }
+    return sizeKey + hash.result();
+}
+}
+
 App::App(QObject* parent)
     : QObject(parent)
     , m_notifyNewData(STDIN_FILENO, QSocketNotifier::Read)
     , m_input()
     , m_output()
     , m_workerPipe(&m_input, &m_output)
-    , m_tr(nullptr)
 {
     m_input.open(STDIN_FILENO, QIODevice::ReadOnly | QIODevice::Unbuffered );
     m_output.open(STDOUT_FILENO, QIODevice::WriteOnly | QIODevice::Unbuffered );
@@ -56,37 +90,21 @@ App::App(QObject* parent)
     connect(&m_workerPipe, &WorkerPipe::inputEnd, this, &QCoreApplication::quit);
 }
 
-App::~App()
-{
-    if (m_tr) {
-        // Abort the transaction in case the parent process exited
-        m_tr->abort();
-        m_tr.reset();
-    }
-}
-
 void App::slotNewBatch(const QVector<quint64>& ids)
 {
     m_ids = ids;
 
-    Database *db = globalDatabaseInstance();
-    if (!db->open(Database::ReadWriteDatabase)) {
+    m_db = globalDatabaseInstance();
+    if (!m_db->open(Database::ReadOnlyDatabase)) {
         qCCritical(BALOO) << "Failed to open the database";
         exit(1);
     }
 
-    Q_ASSERT(m_tr == nullptr);
-
     if (!m_isBusy) {
         m_idleTime->catchNextResumeEvent();
     }
 
-    QTimer::singleShot((m_isBusy ? 500 : 0), this, [this, db] () {
-        // FIXME: The transaction is open for way too long. We should just open it for when we're
-        //        committing the data not during the extraction.
-        m_tr = std::make_unique<Transaction>(db, Transaction::ReadWrite);
-        processNextFile();
-    });
+    QTimer::singleShot((m_isBusy ? 500 : 0), this, &App::processNextFile);
 
     /**
      * A Single Batch seems to be triggering the SocketNotifier more than once
@@ -100,38 +118,49 @@ void App::processNextFile()
     if (!m_ids.isEmpty()) {
         quint64 id = m_ids.takeFirst();
 
-        QString url = QFile::decodeName(m_tr->documentUrl(id));
+        // The extractor only reads the database, the extracted documents are
+        // written by baloo_file. The read transaction is kept short, an open
+        // reader keeps LMDB from reusing the pages freed by the writer.
+        QString url;
+        {
+            Transaction tr(m_db, Transaction::ReadOnly);
+            url = QFile::decodeName(tr.documentUrl(id));
+        }
         if (url.isEmpty() || !QFile::exists(url)) {
-            m_tr->removeDocument(id);
+            sendResult(id, ExtractedFile::RemoveDocument);
             QTimer::singleShot(0, this, &App::processNextFile);
             return;
         }
 
-        bool indexed = index(m_tr.get(), url, id);
+        bool indexed = index(url, id);
 
         int delay = (m_isBusy && indexed) ? 10 : 0;
         QTimer::singleShot(delay, this, &App::processNextFile);
 
     } else {
-        bool ok = m_tr->commit();
-        if (!ok) {
-            exit(2);
-        }
-        m_tr.reset();
-
         // Enable the SocketNotifier for the next batch
         m_notifyNewData.setEnabled(true);
         m_workerPipe.batchFinished();
     }
 }
 
-bool App::index(Transaction* tr, const QString& url, quint64 id)
+void App::sendResult(quint64 id, ExtractedFile::Action action, const Document& doc, const QByteArray& contentHash)
+{
+    ExtractedFile file;
+    file.id = id;
+    file.action = action;
+    file.document = doc;
+    file.contentHash = contentHash;
+    m_workerPipe.fileExtracted(file);
+}
+
+bool App::index(const QString& url, quint64 id)
 {
     if (!m_config.shouldBeIndexed(url)) {
         // This apparently happens when the config has changed after the document
         // was added to the content indexing db
         qCDebug(BALOO) << "Found" << url << "in the ContentIndexingDB, although it should be skipped";
-        tr->removeDocument(id);
+        sendResult(id, ExtractedFile::RemoveDocument);
         m_workerPipe.urlFailed(url);
         return false;
     }
@@ -143,23 +172,11 @@ bool App::index(Transaction* tr, const QString& url, quint64 id)
         qCDebug(BALOO) << "Skipping" << url << "- mimetype:" << mimetype;
         // FIXME: in case the extension based and content based mimetype differ
         // we should update it.
-        tr->removePhaseOne(id);
+        sendResult(id, ExtractedFile::SkipContent);
         m_workerPipe.urlFailed(url);
         return false;
     }
 
-    // HACK: Also, we're ignoring ttext files which are greater tha 10 Mb as we
-    // have trouble processing them
-    //
-    if (mimetype.startsWith(QLatin1String("text/"))) {
-        QFileInfo fileInfo(url);
-        if (fileInfo.size() >= 10 * 1024 * 1024) {
-            qCDebug(BALOO) << "Skipping large " << url << "- mimetype:" << mimetype;
-            tr->removePhaseOne(id);
-            m_workerPipe.urlFailed(url);
-            return false;
-        }
-    }
     qCDebug(BALOO) << "Indexing" << id << url << mimetype;
     m_workerPipe.urlStarted(url);
 
@@ -171,6 +188,46 @@ bool App::index(Transaction* tr, const QString& url, quint64 id)
 
     Baloo::Document doc = basicIndexer.document();
 
+    // Skip the extraction if the contents did not change, e.g. when only
+    // the mtime was touched, or if they are indexed already for a copy.
+    // Hashing reads the whole file and the extractors read it again, so
+    // only files with the size of their previous contents or of another
+    // document are hashed. Others only store the size, a later copy of
+    // them is extracted once more and hashed then.
+    QByteArray contentHash;
+    const qint64 fileSize = QFileInfo(url).size();
+    if (fileSize <= MaxHashedFileSize) {
+        Transaction tr(m_db, Transaction::ReadOnly);
+        const QByteArray sizeKey = fileSizeKey(fileSize);
+        if (!tr.hasContentHashWithPrefix(sizeKey)) {
+            contentHash = sizeKey;
+        } else {
+            contentHash = fileContentHash(url, mimetype, sizeKey);
+        }
+
+        if (contentHash.size() > sizeKey.size() && doc.id() == id) {
+            if (tr.documentContentHash(id) == contentHash) {
+                qCDebug(BALOO) << "Contents unchanged" << url;
+                sendResult(id, ExtractedFile::SkipContent);
+                m_workerPipe.urlFinished(url);
+                return false;
+            }
+
+            const quint64 copyId = tr.documentWithContentHash(contentHash);
+            if (copyId && copyId != id && tr.hasDocument(copyId)) {
+                qCDebug(BALOO) << "Reusing the contents of" << copyId << "for" << url;
+                // Only the terms and data are replaced, see FileContentIndexerProvider::apply()
+                Document contents = tr.documentContents(copyId);
+                contents.setId(id);
+                contents.setParentId(doc.parentId());
+                contents.setUrl(doc.url());
+                sendResult(id, ExtractedFile::ReplaceDocument, contents, contentHash);
+                m_workerPipe.urlFinished(url);
+                return true;
+            }
+        }
+    }
+
     Result result(url, mimetype, KFileMetaData::ExtractionResult::ExtractMetaData | KFileMetaData::ExtractionResult::ExtractPlainText);
     result.setDocument(doc);
 
@@ -181,18 +238,13 @@ bool App::index(Transaction* tr, const QString& url, quint64 id)
     }
 
     result.finish();
+    if (result.droppedTerms() > 0) {
+        qCInfo(BALOO) << "Reached" << Result::MaxTextTerms << "terms in" << url << "- dropped" << result.droppedTerms() << "new words";
+    }
     if (doc.id() != id) {
         qCWarning(BALOO) << url << "id seems to have changed. Perhaps baloo was not running, and this file was deleted + re-created";
-        tr->removeDocument(id);
-        if (!tr->hasDocument(doc.id())) {
-            tr->addDocument(result.document());
-        } else {
-            tr->replaceDocument(result.document(), DocumentTerms | DocumentData);
-        }
-    } else {
-        tr->replaceDocument(result.document(), DocumentTerms | DocumentData);
     }
-    tr->removePhaseOne(doc.id());
+    sendResult(id, ExtractedFile::ReplaceDocument, result.document(), contentHash);
     m_workerPipe.urlFinished(url);
     return true;
 }
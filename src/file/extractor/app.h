@@ -13,8 +13,6 @@
 #include <QSocketNotifier>
 #include <QFile>
 
-#include <memory>
-
 #include <KFileMetaData/ExtractorCollection>
 
 #include "database.h"
@@ -26,22 +24,20 @@ class QString;
 
 namespace Baloo {
 
-class Transaction;
-
 class App : public QObject
 {
     Q_OBJECT
 
 public:
     explicit App(QObject* parent = nullptr);
-    ~App();
 
 private Q_SLOTS:
     void slotNewBatch(const QVector<quint64>& ids);
     void processNextFile();
 
 private:
-    bool index(Transaction* tr, const QString& filePath, quint64 id);
+    bool index(const QString& filePath, quint64 id);
+    void sendResult(quint64 id, ExtractedFile::Action action, const Document& doc = Document(), const QByteArray& contentHash = QByteArray());
 
     QMimeDatabase m_mimeDb;
 
@@ -57,8 +53,8 @@ private:
     KIdleTime* m_idleTime = nullptr;
     bool m_isBusy = true;
 
+    Database* m_db = nullptr;
     QVector<quint64> m_ids;
-    std::unique_ptr<Transaction> m_tr;
 };
 
 }
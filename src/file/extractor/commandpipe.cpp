@@ -10,6 +10,27 @@
 #include "baloodebug.h"
 #include <QIODevice>
 namespace Baloo {
+
+static QDataStream& operator<<(QDataStream& stream, const ExtractedFile& file)
+{
+    stream << file.id << quint8(file.action);
+    if (file.action == ExtractedFile::ReplaceDocument) {
+        stream << file.document << file.contentHash;
+    }
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream& stream, ExtractedFile& file)
+{
+    quint8 action = 0;
+    stream >> file.id >> action;
+    file.action = static_cast<ExtractedFile::Action>(action);
+    if (file.action == ExtractedFile::ReplaceDocument) {
+        stream >> file.document >> file.contentHash;
+    }
+    return stream;
+}
+
 namespace Private {
 
 enum BatchStatus : quint8 {
@@ -17,6 +38,7 @@ enum BatchStatus : quint8 {
     UrlStarted = 'S',
     UrlFinished = 'F',
     UrlFailed = 'f',
+    FileExtracted = 'R',
     BatchFinished = 'B',
 };
 
@@ -54,6 +76,17 @@ void ControllerPipe::processStatusData()
             }
         }
 
+        if (event == FileExtracted) {
+            ExtractedFile file;
+            m_statusStream >> file;
+            if (m_statusStream.commitTransaction()) {
+                Q_EMIT fileExtracted(file);
+                continue;
+            } else {
+                break;
+            }
+        }
+
         m_statusStream >> url;
         if (!m_statusStream.commitTransaction()) {
             break;
@@ -130,6 +163,11 @@ void WorkerPipe::urlFailed(const QString& url)
     m_statusStream << UrlFailed << url;
 }
 
+void WorkerPipe::fileExtracted(const ExtractedFile& file)
+{
+    m_statusStream << FileExtracted << file;
+}
+
 void WorkerPipe::batchFinished()
 {
     m_statusStream << BatchFinished;
@@ -8,12 +8,41 @@
 #ifndef COMMANDPIPE_H
 #define COMMANDPIPE_H
 
+#include "document.h"
+
 #include <QDataStream>
 #include <QObject>
 
 class QIODevice;
 
 namespace Baloo {
+
+/**
+ * The result of processing a single file in an extractor process. The
+ * extractors only read the database, the results are applied by baloo_file.
+ *
+ * The extractor sends exactly one result per id, in the order of the batch.
+ * When the extractor crashes, the file after the last result is the one
+ * which caused the crash.
+ */
+struct ExtractedFile {
+    enum Action : quint8 {
+        /// The file is gone or excluded, remove it from the index
+        RemoveDocument = 'r',
+        /// The file should not be content indexed
+        SkipContent = 's',
+        /// Replace the terms and data with the extracted document
+        ReplaceDocument = 'u',
+    };
+
+    quint64 id = 0;
+    Action action = SkipContent;
+    Document document;
+
+    /// For ReplaceDocument, the hash of the contents, see ContentHashDB
+    QByteArray contentHash;
+};
+
 namespace Private {
 
 /**
@@ -33,6 +62,7 @@ Q_SIGNALS:
     void urlStarted(const QString& url);
     void urlFinished(const QString& url);
     void urlFailed(const QString& url);
+    void fileExtracted(const Baloo::ExtractedFile& file);
     void batchFinished();
 
 public Q_SLOTS:
@@ -53,6 +83,7 @@ public:
     void urlStarted(const QString& url);
     void urlFinished(const QString& url);
     void urlFailed(const QString& url);
+    void fileExtracted(const Baloo::ExtractedFile& file);
     void batchFinished();
 
 public Q_SLOTS:
@@ -69,4 +100,7 @@ private:
 
 } // namespace Private
 } // namespace Baloo
+
+Q_DECLARE_METATYPE(Baloo::ExtractedFile)
+
 #endif
@@ -15,12 +15,18 @@
 #include <KFileMetaData/PropertyInfo>
 #include <KFileMetaData/TypeInfo>
 
+namespace {
+// Larger texts are indexed in chunks, so the term lists stay small
+constexpr int TextChunkSize = 64 * 1024;
+}
+
 // In order to use it in a vector
 Result::Result()
     : ExtractionResult(QString(), QString())
     , m_termGen(m_doc)
     , m_termGenForText(m_doc)
 {
+    m_termGenForText.setMaxTerms(MaxTextTerms);
 }
 
 Result::Result(const QString& url, const QString& mimetype, const Flags& flags)
@@ -28,6 +34,7 @@ Result::Result(const QString& url, const QString& mimetype, const Flags& flags)
     , m_termGen(m_doc)
     , m_termGenForText(m_doc)
 {
+    m_termGenForText.setMaxTerms(MaxTextTerms);
 }
 
 void Result::add(KFileMetaData::Property::Property property, const QVariant& value)
@@ -84,7 +91,20 @@ void Result::add(KFileMetaData::Property::Property property, const QVariant& val
 
 void Result::append(const QString& text)
 {
-    m_termGenForText.indexText(text);
+    if (text.size() <= TextChunkSize) {
+        m_termGenForText.indexText(text);
+        return;
+    }
+
+    // Split after line feeds, these are always word boundaries
+    const QStringView view(text);
+    qsizetype start = 0;
+    while (start < view.size()) {
+        qsizetype end = view.indexOf(QLatin1Char('\n'), start + TextChunkSize);
+        end = end < 0 ? view.size() : end + 1;
+        m_termGenForText.indexText(text.mid(start, end - start));
+        start = end;
+    }
 }
 
 void Result::addType(KFileMetaData::Type::Type type)
@@ -55,6 +55,20 @@ public:
      */
     void finish();
 
+    /**
+     * Together with Document::maxTermPositions, this bounds the memory
+     * used for a file regardless of its size. Text words not in the
+     * document yet are dropped once it has this many terms.
+     */
+    static constexpr int MaxTextTerms = 100000;
+
+    /**
+     * The number of text words dropped because of MaxTextTerms
+     */
+    int droppedTerms() const {
+        return m_termGenForText.droppedTerms();
+    }
+
 private:
     /**
      * The document that represents the file that is to be indexed.
@@ -8,6 +8,10 @@
 #include "baloodebug.h"
 #include "extractorprocess.h"
 
+#include <QFile>
+
+#include <unistd.h>
+
 using namespace Baloo;
 
 ExtractorProcess::ExtractorProcess(const QString& extractorPath, QObject* parent)
@@ -26,6 +30,7 @@ ExtractorProcess::ExtractorProcess(const QString& extractorPath, QObject* parent
     connect(&m_controller, &ControllerPipe::urlFailed, this, [this](const QString& url) {
         Q_EMIT finishedIndexingFile(url, false);
     });
+    connect(&m_controller, &ControllerPipe::fileExtracted, this, &ExtractorProcess::fileExtracted);
     connect(&m_controller, &ControllerPipe::batchFinished, this, [this]() {
         qCDebug(BALOO) << "Batch finished";
         Q_EMIT done();
@@ -71,10 +76,40 @@ void ExtractorProcess::start()
     m_extractorProcess.setReadChannel(QProcess::StandardOutput);
 }
 
+void ExtractorProcess::restart()
+{
+    m_extractorProcess.closeWriteChannel();
+    m_extractorProcess.waitForFinished();
+    start();
+}
+
 void ExtractorProcess::index(const QVector<quint64>& fileIds)
 {
     Q_ASSERT(!fileIds.isEmpty());
     m_controller.processIds(fileIds);
 }
 
+qint64 ExtractorProcess::memoryUsage() const
+{
+#ifdef Q_OS_LINUX
+    const qint64 pid = m_extractorProcess.processId();
+    if (pid == 0) {
+        return 0;
+    }
+
+    // The second field is the resident set size in pages
+    QFile statm(QStringLiteral("/proc/%1/statm").arg(pid));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
 #include "moc_extractorprocess.cpp"
@@ -25,9 +25,21 @@ public:
     void index(const QVector<quint64>& fileIds);
     void start();
 
+    /**
+     * Lets the running extractor exit and starts a new one, which gives
+     * back the memory the old one accumulated
+     */
+    void restart();
+
+    /**
+     * The resident memory of the extractor process in bytes, 0 if unknown
+     */
+    qint64 memoryUsage() const;
+
 Q_SIGNALS:
     void startedIndexingFile(QString filePath);
     void finishedIndexingFile(QString filePath, bool fileUpdated);
+    void fileExtracted(const Baloo::ExtractedFile& file);
     void done();
     void failed();
 
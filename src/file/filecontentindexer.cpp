@@ -14,6 +14,10 @@
 #include <QElapsedTimer>
 #include <QDBusConnection>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 using namespace Baloo;
 
 namespace {
@@ -28,11 +32,12 @@ namespace {
     }
 }
 
-FileContentIndexer::FileContentIndexer(uint batchSize,
+FileContentIndexer::FileContentIndexer(uint batchSize, uint processCount,
         FileContentIndexerProvider* provider,
         uint& finishedCount, QObject* parent)
     : QObject(parent)
     , m_batchSize(batchSize)
+    , m_processCount(qMax(processCount, 1u))
     , m_provider(provider)
     , m_finishedCount(finishedCount)
     , m_stop(0)
@@ -52,61 +57,173 @@ FileContentIndexer::FileContentIndexer(uint batchSize,
 
 void FileContentIndexer::run()
 {
-    ExtractorProcess process{m_extractorPath};
-    connect(&process, &ExtractorProcess::startedIndexingFile, this, &FileContentIndexer::slotStartedIndexingFile);
-    connect(&process, &ExtractorProcess::finishedIndexingFile, this, &FileContentIndexer::slotFinishedIndexingFile);
+    // The extractor processes only extract the files, all results are
+    // written here, so there is still a single writer to the database
+    std::vector<std::unique_ptr<ExtractorProcess>> processes;
+    for (uint i = 0; i < m_processCount; i++) {
+        auto process = std::make_unique<ExtractorProcess>(m_extractorPath);
+        connect(process.get(), &ExtractorProcess::startedIndexingFile, this, &FileContentIndexer::slotStartedIndexingFile);
+        connect(process.get(), &ExtractorProcess::finishedIndexingFile, this, &FileContentIndexer::slotFinishedIndexingFile);
+        processes.push_back(std::move(process));
+    }
     m_stop.storeRelaxed(false);
-    auto batchSize = m_batchSize;
+
+    // The remaining files of slices which failed
+    QVector<QVector<quint64>> retries;
     while (true) {
-        //
-        // WARNING: This will go mad, if the Extractor does not commit after N=m_batchSize files
-        // cause then we will keep fetching the same N files again and again.
-        //
-        QVector<quint64> idList = m_provider->fetch(batchSize);
-        if (idList.isEmpty() || m_stop.loadRelaxed()) {
+        QVector<QVector<quint64>> slices;
+        if (!retries.isEmpty()) {
+            while (!retries.isEmpty() && slices.size() < static_cast<int>(processes.size())) {
+                slices << retries.takeFirst();
+            }
+        } else {
+            //
+            // WARNING: This will go mad, if the results are not committed after N=m_batchSize files
+            // cause then we will keep fetching the same N files again and again.
+            //
+            const QVector<quint64> idList = m_provider->fetch(m_batchSize.batchSize());
+            const int sliceSize = (idList.size() + processes.size() - 1) / processes.size();
+            for (int i = 0; i < idList.size(); i += sliceSize) {
+                slices << idList.mid(i, sliceSize);
+            }
+        }
+        if (slices.isEmpty() || m_stop.loadRelaxed()) {
             break;
         }
-        QEventLoop loop;
-        connect(&process, &ExtractorProcess::done, &loop, &QEventLoop::quit);
 
-        bool hadErrors = false;
-        connect(&process, &ExtractorProcess::failed, &loop, [&hadErrors, &loop]() { hadErrors = true; loop.quit(); });
+        struct SliceState {
+            QVector<ExtractedFile> results;
+            QStringList updatedFiles;
+            uint finishedCount = 0;
+            int extractedCount = 0;
+            bool done = false;
+            bool failed = false;
+        };
+        QVector<SliceState> states(slices.size());
 
-        uint batchStartCount = m_finishedCount;
-        connect(&process, &ExtractorProcess::finishedIndexingFile, &loop, [this]() { m_finishedCount++; });
+        // The resident size of a long running extractor says little about
+        // the current batch, the batch size follows the growth instead
+        QVector<qint64> startMemory(slices.size());
+        for (int i = 0; i < slices.size(); i++) {
+            startMemory[i] = processes[i]->memoryUsage();
+        }
+
+        QStringList updatedFiles;
+        uint processedCount = 0;
+        QElapsedTimer commitTimer;
+        qint64 commitTime = 0;
+
+        // The results of a slice are written as soon as its extractor is
+        // done, so the write transaction only lasts for applying the results
+        // of one slice, and the documents are not kept around any longer.
+        // The results of a failed slice are complete for all files before
+        // the failing one, and are written as well.
+        auto applySlice = [this, &updatedFiles, &processedCount, &commitTimer, &commitTime](SliceState* state) {
+            commitTimer.start();
+            if (!state->results.isEmpty() && !m_provider->apply(state->results)) {
+                qCCritical(BALOO) << "Not able to commit to DB, DB likely is in a bad state. Exiting";
+                exit(1);
+            }
+            commitTime += commitTimer.elapsed();
+            m_finishedCount += state->finishedCount;
+            processedCount += state->results.size();
+            updatedFiles << state->updatedFiles;
+            state->extractedCount = state->results.size();
+            state->results.clear();
+        };
 
+        QEventLoop loop;
         QElapsedTimer timer;
         timer.start();
 
-        process.index(idList);
-        loop.exec();
-        batchSize = idList.size();
+        {
+            // Disconnects the per batch connections when going out of scope
+            QObject batchContext;
+            int pending = slices.size();
+            for (int i = 0; i < slices.size(); i++) {
+                ExtractorProcess* process = processes[i].get();
+                SliceState* state = &states[i];
+                auto sliceDone = [state, &pending, &loop, &applySlice](bool failed) {
+                    if (state->done) {
+                        return;
+                    }
+                    state->done = true;
+                    state->failed = failed;
+                    applySlice(state);
+                    if (--pending == 0) {
+                        loop.quit();
+                    }
+                };
+                connect(process, &ExtractorProcess::fileExtracted, &batchContext, [state](const ExtractedFile& file) {
+                    state->results << file;
+                });
+                connect(process, &ExtractorProcess::finishedIndexingFile, &batchContext, [state](const QString& filePath, bool fileUpdated) {
+                    state->finishedCount++;
+                    if (fileUpdated) {
+                        state->updatedFiles << filePath;
+                    }
+                });
+                connect(process, &ExtractorProcess::done, &batchContext, [sliceDone]() { sliceDone(false); });
+                connect(process, &ExtractorProcess::failed, &batchContext, [sliceDone]() { sliceDone(true); });
+
+                process->index(slices[i]);
+            }
+            loop.exec();
+        }
 
-        if (hadErrors && !m_stop.loadRelaxed()) {
-            if (batchSize == 1) {
-                auto failedId = idList.first();
-                auto ok = m_provider->markFailed(failedId);
-                if (!ok) {
+        if (m_stop.loadRelaxed()) {
+            break;
+        }
+
+        qint64 memoryGrowth = 0;
+        for (int i = 0; i < slices.size(); i++) {
+            if (states[i].failed) {
+                continue;
+            }
+            const qint64 memoryUsage = processes[i]->memoryUsage();
+            if (startMemory[i] > 0 && memoryUsage > 0) {
+                memoryGrowth = std::max(memoryGrowth, memoryUsage - startMemory[i]);
+            }
+            if (memoryUsage > BatchSizeController::MemoryLimit) {
+                qCDebug(BALOO) << "Restarting extractor using" << memoryUsage / (1024 * 1024) << "MiB";
+                processes[i]->restart();
+            }
+        }
+        const uint previousBatchSize = m_batchSize.batchSize();
+        m_batchSize.handleBatch(processedCount, timer.elapsed(), commitTime, memoryGrowth);
+        if (m_batchSize.batchSize() != previousBatchSize) {
+            qCDebug(BALOO) << "Content indexing batch size" << m_batchSize.batchSize();
+        }
+
+        for (int i = 0; i < slices.size(); i++) {
+            if (!states[i].failed) {
+                continue;
+            }
+            // The extractor sends one result per file, in the order of the
+            // slice, so the failing file is the one after the last result
+            const QVector<quint64>& slice = slices[i];
+            const int failedIndex = states[i].extractedCount;
+            if (failedIndex < slice.size()) {
+                if (!m_provider->markFailed(slice[failedIndex])) {
                     qCCritical(BALOO) << "Not able to commit to DB, DB likely is in a bad state. Exiting";
                     exit(1);
                 }
-                batchSize = m_batchSize;
-            } else {
-                batchSize /= 2;
+                const QVector<quint64> remaining = slice.mid(failedIndex + 1);
+                if (!remaining.isEmpty()) {
+                    retries << remaining;
+                }
             }
-            m_updatedFiles.clear();
-            // reset to old value - nothing committed
-            m_finishedCount = batchStartCount;
-            process.start();
-        } else {
-            // Notify some metadata may have changed
-            sendChangedSignal(m_updatedFiles);
-            m_updatedFiles.clear();
+            processes[i]->start();
+        }
+
+        // Notify some metadata may have changed
+        sendChangedSignal(updatedFiles);
 
-            // Update remaining time estimate
+        // Update remaining time estimate
+        if (processedCount > 0) {
             auto elapsed = timer.elapsed();
             QMetaObject::invokeMethod(this,
-                [this, elapsed, batchSize] { committedBatch(elapsed, batchSize); },
+                [this, elapsed, processedCount] { committedBatch(elapsed, processedCount); },
                 Qt::QueuedConnection);
         }
     }
@@ -123,9 +240,7 @@ void FileContentIndexer::slotStartedIndexingFile(const QString& filePath)
 
 void FileContentIndexer::slotFinishedIndexingFile(const QString& filePath, bool fileUpdated)
 {
-    if (fileUpdated) {
-        m_updatedFiles.append(filePath);
-    }
+    Q_UNUSED(fileUpdated)
 
     m_currentFile = QString();
     if (!m_registeredMonitors.isEmpty()) {
@@ -15,6 +15,8 @@
 #include <QDBusServiceWatcher>
 #include <QDBusMessage>
 
+#include "batchsizecontroller.h"
+
 namespace Baloo {
 
 class FileContentIndexerProvider;
@@ -26,7 +28,7 @@ class FileContentIndexer : public QObject, public QRunnable
 
     Q_PROPERTY(QString currentFile READ currentFile NOTIFY startedIndexingFile)
 public:
-    FileContentIndexer(uint batchSize, FileContentIndexerProvider* provider, uint& finishedCount, QObject* parent = nullptr);
+    FileContentIndexer(uint batchSize, uint processCount, FileContentIndexerProvider* provider, uint& finishedCount, QObject* parent = nullptr);
 
     QString currentFile() { return m_currentFile; }
 
@@ -53,14 +55,14 @@ private Q_SLOTS:
     void slotFinishedIndexingFile(const QString& filePath, bool fileUpdated);
 
 private:
-    uint m_batchSize;
+    BatchSizeController m_batchSize;
+    uint m_processCount;
     FileContentIndexerProvider* m_provider;
     uint& m_finishedCount;
 
     QAtomicInt m_stop;
 
     QString m_currentFile;
-    QStringList m_updatedFiles;
 
     QStringList m_registeredMonitors;
     QDBusServiceWatcher m_monitorWatcher;
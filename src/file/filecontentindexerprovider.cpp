@@ -37,3 +37,39 @@ bool FileContentIndexerProvider::markFailed(quint64 id)
     tr.removePhaseOne(id);
     return tr.commit();
 }
+
+bool FileContentIndexerProvider::apply(const QVector<ExtractedFile>& files)
+{
+    Transaction tr(m_db, Transaction::ReadWrite);
+    for (const ExtractedFile& file : files) {
+        switch (file.action) {
+        case ExtractedFile::RemoveDocument:
+            tr.removeDocument(file.id);
+            break;
+        case ExtractedFile::SkipContent:
+            tr.removePhaseOne(file.id);
+            break;
+        case ExtractedFile::ReplaceDocument: {
+            // The document might have been removed while it was extracted
+            if (!tr.hasDocument(file.id)) {
+                break;
+            }
+            const Document& doc = file.document;
+            if (doc.id() != file.id) {
+                tr.removeDocument(file.id);
+                if (!tr.hasDocument(doc.id())) {
+                    tr.addDocument(doc);
+                } else {
+                    tr.replaceDocument(doc, DocumentTerms | DocumentData);
+                }
+            } else {
+                tr.replaceDocument(doc, DocumentTerms | DocumentData);
+            }
+            tr.setDocumentContentHash(doc.id(), file.contentHash);
+            tr.removePhaseOne(doc.id());
+            break;
+        }
+        }
+    }
+    return tr.commit();
+}
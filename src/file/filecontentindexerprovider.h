@@ -7,6 +7,8 @@
 #ifndef BALOO_FILECONTENTINDEXERPROVIDER_H
 #define BALOO_FILECONTENTINDEXERPROVIDER_H
 
+#include "extractor/commandpipe.h"
+
 #include <QVector>
 
 namespace Baloo {
@@ -22,6 +24,11 @@ public:
     QVector<quint64> fetch(uint size);
     bool markFailed(quint64 id);
 
+    /**
+     * Writes the results of the extractor processes in a single transaction
+     */
+    bool apply(const QVector<ExtractedFile>& files);
+
 private:
     Database* m_db;
 };
@@ -16,6 +16,7 @@
 #include <QDir>
 
 #include <QStandardPaths>
+#include <QThread>
 #include "baloosettings.h"
 
 namespace
@@ -41,6 +42,7 @@ FileIndexerConfig::FileIndexerConfig(QObject* parent)
     , m_indexHidden(false)
     , m_devices(nullptr)
     , m_maxUncomittedFiles(40)
+    , m_transactionMemoryBudget(64 * 1024 * 1024)
 {
     forceConfigUpdate();
 }
@@ -354,6 +356,8 @@ void FileIndexerConfig::forceConfigUpdate()
 
     m_indexHidden = m_settings->indexHiddenFolders();
     m_onlyBasicIndexing = m_settings->onlyBasicIndexing();
+    m_fastRescan = m_settings->fastRescan();
+    m_fastRescanRecentDays = m_settings->fastRescanRecentDays();
 }
 
 int FileIndexerConfig::databaseVersion() const
@@ -377,6 +381,34 @@ uint FileIndexerConfig::maxUncomittedFiles() const
     return m_maxUncomittedFiles;
 }
 
+qint64 FileIndexerConfig::transactionMemoryBudget() const
+{
+    return m_transactionMemoryBudget;
+}
+
+uint FileIndexerConfig::extractorProcessCount() const
+{
+    // Leave some cores to the user, extraction runs in the background
+    return qBound(1, QThread::idealThreadCount() / 2, 4);
+}
+
+uint FileIndexerConfig::crawlerThreadCount() const
+{
+    // The crawl mostly waits for the filesystem, a few threads beyond the
+    // cores still help with cold caches and network filesystems
+    return qBound(2, QThread::idealThreadCount(), 8);
+}
+
+bool FileIndexerConfig::fastRescan() const
+{
+    return m_fastRescan;
+}
+
+uint FileIndexerConfig::fastRescanRecentDays() const
+{
+    return m_fastRescanRecentDays;
+}
+
 } // namespace Baloo
 
 #include "moc_fileindexerconfig.cpp"
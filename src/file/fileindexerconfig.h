@@ -129,10 +129,51 @@ public:
     bool indexingEnabled() const;
 
     /**
-      * Returns batch size
+      * Returns batch size. For content indexing this is the initial
+      * size, see BatchSizeController.
       */
     uint maxUncomittedFiles() const;
 
+    /**
+      * Returns the memory budget in bytes for the pending posting list
+      * changes of a transaction, see Transaction::setMemoryBudget()
+      */
+    qint64 transactionMemoryBudget() const;
+
+    /**
+      * Returns the number of extractor processes used for content indexing.
+      * Each batch of content indexing is split between them.
+      */
+    uint extractorProcessCount() const;
+
+    /**
+      * Returns the number of threads crawling the include folders in the
+      * basic indexing, see DirectoryCrawler.
+      */
+    uint crawlerThreadCount() const;
+
+    /**
+      * Whether the crawls store a fingerprint of each folder, and the
+      * check for unindexed files skips the files of the folders which
+      * still match it, see FolderFingerprintDB.
+      *
+      * A file modified in place does not change its folder. Only the files
+      * indexed with a modification time in the last fastRescanRecentDays()
+      * days are checked in an unchanged folder, older files modified while
+      * baloo was not running are missed until they change again.
+      *
+      * The files of unchanged folders are identified by the inode of the
+      * directory entry instead of a stat. On overlay and FUSE filesystems,
+      * where the two can differ, the files are stat'ed anyway.
+      */
+    bool fastRescan() const;
+
+    /**
+      * Returns the number of days in which the indexed files of an
+      * unchanged folder count as recently modified, see fastRescan()
+      */
+    uint fastRescanRecentDays() const;
+
 public Q_SLOTS:
     /**
      * Reread the config from disk and update the configuration cache.
@@ -184,10 +225,13 @@ private:
 
     bool m_indexHidden;
     bool m_onlyBasicIndexing;
+    bool m_fastRescan;
+    uint m_fastRescanRecentDays;
 
     StorageDevices* m_devices;
 
     const uint m_maxUncomittedFiles;
+    const qint64 m_transactionMemoryBudget;
 };
 
 QDebug operator<<(QDebug dbg, const FileIndexerConfig::FolderCache::value_type&);
@@ -58,6 +58,11 @@ FileWatch::~FileWatch()
 {
 }
 
+void FileWatch::setMetadataUpdatesSuspended(bool suspended)
+{
+    m_metadataMover->setSuspended(suspended);
+}
+
 // FIXME: listen to Create for folders!
 void FileWatch::watchFolder(const QString& path)
 {
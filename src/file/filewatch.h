@@ -36,6 +36,12 @@ public Q_SLOTS:
      */
     void updateIndexedFoldersWatches();
 
+    /**
+     * Holds back the changes of moved and removed files in the database,
+     * see MetadataMover::setSuspended()
+     */
+    void setMetadataUpdatesSuspended(bool suspended);
+
 Q_SIGNALS:
     void indexNewFile(const QString& string);
     void indexModifiedFile(const QString& string);
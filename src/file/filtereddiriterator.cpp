@@ -6,104 +6,332 @@
 
 #include "filtereddiriterator.h"
 #include "fileindexerconfig.h"
+#include "idutils.h"
+
+#include <QFile>
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#ifdef Q_OS_LINUX
+#include <sys/vfs.h>
+#endif
 
 using namespace Baloo;
 
-FilteredDirIterator::FilteredDirIterator(const FileIndexerConfig* config, const QString& folder, Filter filter)
+namespace {
+int statAt(int dirFd, const char* name, QT_STATBUF* statBuf)
+{
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+    return ::fstatat64(dirFd, name, statBuf, AT_SYMLINK_NOFOLLOW);
+#else
+    return ::fstatat(dirFd, name, statBuf, AT_SYMLINK_NOFOLLOW);
+#endif
+}
+
+// Whether the d_ino of the entries is their st_ino. Overlay filesystems
+// return the inode of the underlying layer in readdir() for some files,
+// FUSE filesystems anything they like.
+bool hasStatInodes(int dirFd)
+{
+#ifdef Q_OS_LINUX
+    // from linux/magic.h, and FUSE_SUPER_MAGIC from fs/fuse
+    constexpr long OverlayfsMagic = 0x794c7630;
+    constexpr long AufsMagic = 0x61756673;
+    constexpr long FuseMagic = 0x65735546;
+
+    struct statfs fsBuf;
+    if (fstatfs(dirFd, &fsBuf) != 0) {
+        return false;
+    }
+    switch (static_cast<long>(fsBuf.f_type)) {
+    case OverlayfsMagic:
+    case AufsMagic:
+    case FuseMagic:
+        return false;
+    default:
+        return true;
+    }
+#else
+    Q_UNUSED(dirFd);
+    return true;
+#endif
+}
+}
+
+FilteredDirIterator::FilteredDirIterator(const FileIndexerConfig* config, const QString& folder, Filter filter, Recursion recursion)
     : m_config(config)
-    , m_currentIter(nullptr)
-    , m_filters(QDir::NoDotAndDotDot | QDir::Readable | QDir::NoSymLinks | QDir::Hidden)
+    , m_filter(filter)
+    , m_recursion(recursion)
+    , m_indexHidden(config && config->indexHiddenFilesAndFolders())
+    , m_dir(nullptr)
+    , m_dirDev(0)
+    , m_dirFsid(0)
+    , m_dirId(0)
+    , m_parentId(0)
+    , m_entryName(nullptr)
+    , m_entryCount(0)
+    , m_skipFileStat(false)
+    , m_dirStatInodes(false)
+    , m_hasStat(true)
+    , m_isDir(false)
     , m_firstItem(false)
+    , m_followStart(false)
+    , m_startId(0)
 {
-    if (filter == DirsOnly) {
-        m_filters |= QDir::Dirs;
-    } else if (filter == FilesAndDirs) {
-        m_filters |= (QDir::Files | QDir::Dirs);
+    const QByteArray path = QFile::encodeName(folder);
+    if (m_recursion == ChildrenOnly) {
+        m_paths.push(path);
+        return;
+    }
+
+    if (m_config && !m_config->shouldFolderBeIndexed(folder)) {
+        return;
     }
 
-    if (!m_config || m_config->shouldFolderBeIndexed(folder)) {
-        m_currentIter = new QDirIterator(folder, m_filters);
-        m_firstItem = true;
+    if (filePathToStat(path, m_statBuf) != 0) {
+        return;
     }
+    if (!S_ISDIR(m_statBuf.st_mode)) {
+        // An include folder may be a symlink to a folder
+        QT_STATBUF targetStatBuf;
+        if (!S_ISLNK(m_statBuf.st_mode) || QT_STAT(path.constData(), &targetStatBuf) != 0 || !S_ISDIR(targetStatBuf.st_mode)) {
+            return;
+        }
+    }
+
+    m_filePath = folder;
+    m_isDir = true;
+    m_firstItem = true;
+    m_followStart = true;
+    m_startId = statBufToId(m_statBuf);
+    m_paths.push(path);
 }
 
 FilteredDirIterator::~FilteredDirIterator()
 {
-    delete m_currentIter;
+    closeDirectory();
+}
+
+bool FilteredDirIterator::openDirectory(const QByteArray& path, bool followSymlink)
+{
+    // The subfolders have been checked not to be symlinks when reading
+    // them, this catches them being replaced by one since
+    const int fd = QT_OPEN(path.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | (followSymlink ? 0 : O_NOFOLLOW));
+    if (fd < 0) {
+        return false;
+    }
+
+    QT_STATBUF dirStatBuf;
+    if (QT_FSTAT(fd, &dirStatBuf) != 0) {
+        QT_CLOSE(fd);
+        return false;
+    }
+    m_dirDev = dirStatBuf.st_dev;
+    m_dirFsid = dirStatBuf.st_dev;
+
+    // The filesystem id is the same for all entries on the filesystem of
+    // the directory, fetch it once instead of a statvfs() per entry
+    struct statvfs fsBuf;
+    if (fstatvfs(fd, &fsBuf) == 0 && fsBuf.f_fsid != 0) {
+        m_dirFsid = foldFsid(fsBuf.f_fsid);
+    }
+    dirStatBuf.st_dev = m_dirFsid;
+    m_dirId = statBufToId(dirStatBuf);
+    m_dirStatInodes = m_skipFileStat && hasStatInodes(fd);
+
+    m_dir = fdopendir(fd);
+    if (!m_dir) {
+        QT_CLOSE(fd);
+        return false;
+    }
+
+    m_dirPath = path;
+    if (!m_dirPath.endsWith('/')) {
+        m_dirPath.append('/');
+    }
+    m_dirPathString = QFile::decodeName(m_dirPath);
+    return true;
+}
+
+void FilteredDirIterator::closeDirectory()
+{
+    if (m_dir) {
+        closedir(m_dir);
+        m_dir = nullptr;
+    }
+}
+
+bool FilteredDirIterator::statEntry(const char* name)
+{
+    if (statAt(dirfd(m_dir), name, &m_statBuf) != 0) {
+        return false;
+    }
+
+    if (m_statBuf.st_dev == m_dirDev) {
+        m_statBuf.st_dev = m_dirFsid;
+    } else {
+        // A mount point
+        const QByteArray path = m_dirPath + name;
+        struct statvfs fsBuf;
+        if (statvfs(path.constData(), &fsBuf) == 0 && fsBuf.f_fsid != 0) {
+            m_statBuf.st_dev = foldFsid(fsBuf.f_fsid);
+        }
+    }
+    return true;
+}
+
+bool FilteredDirIterator::isReadable(const char* name) const
+{
+    // Only the owner permissions apply to the own files, these do not
+    // need another syscall
+    const uid_t uid = geteuid();
+    if (uid == 0) {
+        return true;
+    }
+    if (m_statBuf.st_uid == uid) {
+        return m_statBuf.st_mode & S_IRUSR;
+    }
+    return faccessat(dirfd(m_dir), name, R_OK, 0) == 0;
+}
+
+bool FilteredDirIterator::shouldIndexFolder(const QString& fileName, bool hidden) const
+{
+    if (!m_config) {
+        return !hidden;
+    }
+    QString folder;
+    if (!m_config->folderInFolderList(m_filePath, folder)) {
+        return false;
+    }
+    if ((folder == m_filePath) || (folder == QString(m_filePath).append(QLatin1Char('/')))) {
+        return true;
+    }
+    if (!m_indexHidden && hidden) {
+        return false;
+    }
+    return m_config->shouldFileBeIndexed(fileName);
+}
+
+bool FilteredDirIterator::shouldIndexFile(const QString& fileName, bool hidden) const
+{
+    if (!m_indexHidden && hidden) {
+        return false;
+    }
+    return !m_config || m_config->shouldFileBeIndexed(fileName);
 }
 
 QString FilteredDirIterator::next()
 {
     if (m_firstItem) {
         m_firstItem = false;
-        m_filePath = m_currentIter->path();
-        m_fileInfo = QFileInfo(m_filePath);
         return m_filePath;
     }
 
     m_filePath.clear();
-    if (!m_currentIter) {
-        m_fileInfo = QFileInfo();
-        return QString();
-    }
-
-    bool shouldIndexHidden = false;
-    if (m_config) {
-        shouldIndexHidden = m_config->indexHiddenFilesAndFolders();
-    }
+    m_isDir = false;
+    m_hasStat = true;
+    m_entryName = nullptr;
 
     while (true) {
         // Last entry in the current directory found, try the next
         // directory from the stack
-        // Loop until the directory is non-empty, or the stack is empty
-        while (!m_currentIter->hasNext()) {
-            delete m_currentIter;
-            m_currentIter = nullptr;
-
+        // Loop until a directory can be opened, or the stack is empty
+        while (!m_dir) {
             if (m_paths.isEmpty()) {
-                m_fileInfo = QFileInfo();
+                m_filePath.clear();
                 return QString();
             }
+            if (openDirectory(m_paths.pop(), m_followStart) && m_followStart) {
+                m_dirId = m_startId;
+            }
+            m_followStart = false;
+        }
 
-            const QString path = m_paths.pop();
-            m_currentIter = new QDirIterator(path, m_filters);
+        const struct dirent* entry = readdir(m_dir);
+        if (!entry) {
+            closeDirectory();
+            continue;
         }
 
-        m_filePath = m_currentIter->next();
-        m_fileInfo = m_currentIter->fileInfo();
+        const char* name = entry->d_name;
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) {
+            continue;
+        }
+        m_entryCount++;
+        const bool hidden = name[0] == '.';
 
-        auto shouldIndexFolder = [&] () -> bool {
-            if (!m_config) {
-                return !m_fileInfo.isHidden();
-            }
-            QString folder;
-            if (!m_config->folderInFolderList(m_filePath, folder)) {
-                return false;
-            }
-	    if ((folder == m_filePath) || (folder == QString(m_filePath).append(QLatin1Char('/')))) {
-                return true;
-            }
-            if (!shouldIndexHidden && m_fileInfo.isHidden()) {
-                return false;
+        // Use the entry type if the filesystem provides it
+        bool statDone = false;
+        switch (entry->d_type) {
+        case DT_DIR:
+            m_isDir = true;
+            break;
+        case DT_REG:
+            m_isDir = false;
+            break;
+        case DT_UNKNOWN:
+            if (!statEntry(name)) {
+                continue;
             }
-            return m_config->shouldFileBeIndexed(m_fileInfo.fileName());
-        };
-
-        if (m_fileInfo.isDir()) {
-            if (shouldIndexFolder()) {
-                // Push the current item to the directory stack
-                m_paths.push(m_filePath);
-                return m_filePath;
+            statDone = true;
+            if (S_ISDIR(m_statBuf.st_mode)) {
+                m_isDir = true;
+            } else if (S_ISREG(m_statBuf.st_mode)) {
+                m_isDir = false;
+            } else {
+                continue;
             }
+            break;
+        default:
+            // Symlinks and special files
+            continue;
+        }
+
+        if (!m_isDir && m_filter == DirsOnly) {
+            continue;
         }
-        else if (m_fileInfo.isFile()) {
-            if ((!shouldIndexHidden) && m_fileInfo.isHidden()) {
+
+        const QString fileName = QFile::decodeName(name);
+        m_filePath = m_dirPathString + fileName;
+        m_parentId = m_dirId;
+        if (m_isDir ? !shouldIndexFolder(fileName, hidden) : !shouldIndexFile(fileName, hidden)) {
+            continue;
+        }
+
+        if (!statDone && !m_isDir && m_dirStatInodes) {
+            // The id, as statEntry() would give it for a file on the
+            // filesystem of the directory
+            memset(&m_statBuf, 0, sizeof(m_statBuf));
+            m_statBuf.st_dev = m_dirFsid;
+            m_statBuf.st_ino = entry->d_ino;
+            m_statBuf.st_mode = S_IFREG;
+            m_entryName = name;
+            m_hasStat = false;
+            return m_filePath;
+        }
+
+        if (!statDone) {
+            if (!statEntry(name)) {
                 continue;
             }
-            if ((!m_config) || m_config->shouldFileBeIndexed(m_fileInfo.fileName())) {
-                return m_filePath;
+            // The entry has been replaced since reading the directory
+            if (m_isDir ? !S_ISDIR(m_statBuf.st_mode) : !S_ISREG(m_statBuf.st_mode)) {
+                continue;
             }
         }
+
+        if (!isReadable(name)) {
+            continue;
+        }
+
+        if (m_isDir && m_recursion == Recursive) {
+            m_paths.push(m_dirPath + name);
+        }
+        return m_filePath;
     }
 }
 
@@ -112,7 +340,43 @@ QString FilteredDirIterator::filePath() const
     return m_filePath;
 }
 
-QFileInfo FilteredDirIterator::fileInfo() const
+const QT_STATBUF& FilteredDirIterator::statBuf() const
+{
+    return m_statBuf;
+}
+
+bool FilteredDirIterator::isDir() const
+{
+    return m_isDir;
+}
+
+quint64 FilteredDirIterator::parentId() const
+{
+    return m_parentId;
+}
+
+void FilteredDirIterator::setFileStatSkipped(bool skipped)
+{
+    m_skipFileStat = skipped;
+}
+
+bool FilteredDirIterator::hasStat() const
+{
+    return m_hasStat;
+}
+
+bool FilteredDirIterator::stat()
+{
+    if (m_hasStat) {
+        return true;
+    }
+    Q_ASSERT(m_dir && m_entryName);
+
+    m_hasStat = true;
+    return statEntry(m_entryName) && S_ISREG(m_statBuf.st_mode) && isReadable(m_entryName);
+}
+
+quint32 FilteredDirIterator::entryCount() const
 {
-    return m_fileInfo;
+    return m_entryCount;
 }
@@ -7,14 +7,29 @@
 #ifndef FILTEREDDIRITERATOR_H
 #define FILTEREDDIRITERATOR_H
 
-#include <QDirIterator>
-#include <QFileInfo>
+#include <QByteArray>
 #include <QStack>
+#include <QString>
+
+#include <qplatformdefs.h>
+#include <dirent.h>
 
 namespace Baloo {
 
 class FileIndexerConfig;
 
+/**
+ * Iterates recursively over the files and folders to be indexed below
+ * a folder, starting with the folder itself.
+ *
+ * The entries are read with readdir(), and the entry type is used to
+ * skip symlinks, special files and filtered names without a stat call.
+ * The remaining entries are stat'ed relative to the open directory. The
+ * stat is available as statBuf(), so it does not have to be repeated.
+ *
+ * The folder itself may be a symlink to a folder, like an include folder
+ * linking elsewhere. Symlinks below it are skipped.
+ */
 class FilteredDirIterator
 {
 public:
@@ -22,7 +37,17 @@ public:
         FilesAndDirs,
         DirsOnly,
     };
-    FilteredDirIterator(const FileIndexerConfig* config, const QString& folder, Filter filter = FilesAndDirs);
+    enum Recursion {
+        Recursive,
+        /// The subfolders are returned, but not descended into
+        NotRecursive,
+        /// Like NotRecursive, but the folder itself is neither checked
+        /// against the config nor returned. For the subfolders returned by
+        /// a NotRecursive iterator.
+        ChildrenOnly,
+    };
+    FilteredDirIterator(const FileIndexerConfig* config, const QString& folder, Filter filter = FilesAndDirs,
+                        Recursion recursion = Recursive);
     ~FilteredDirIterator();
 
     FilteredDirIterator(const FilteredDirIterator &) = delete;
@@ -30,18 +55,89 @@ public:
 
     QString next();
     QString filePath() const;
-    QFileInfo fileInfo() const;
+
+    /**
+     * The lstat() of the current item. Like filePathToStat(), the st_dev
+     * is replaced by the filesystem id, so statBufToId() gives the id
+     * of the document.
+     */
+    const QT_STATBUF& statBuf() const;
+    bool isDir() const;
+
+    /**
+     * The id of the folder containing the current item, taken from the
+     * open directory. 0 for the folder the iteration starts with.
+     */
+    quint64 parentId() const;
+
+    /**
+     * Returns the regular files without a stat, when the filesystem
+     * provides the entry type. Only the id and the type of such a file
+     * are known, and it is not checked for readability. See stat().
+     *
+     * The id is taken from the inode of the directory entry. Overlay and
+     * FUSE filesystems may return other inodes there than stat(), their
+     * files are always stat'ed. Has to be called before the first next().
+     */
+    void setFileStatSkipped(bool skipped);
+
+    /**
+     * Whether the current item has been stat'ed, see setFileStatSkipped()
+     */
+    bool hasStat() const;
+
+    /**
+     * Stats the current item if it has not been stat'ed yet. Returns false
+     * if it cannot be stat'ed, is no longer a regular file or is not
+     * readable, it is to be skipped then.
+     */
+    bool stat();
+
+    /**
+     * The number of entries read from the directories so far, including
+     * the filtered ones. The number of entries of the folder for a
+     * ChildrenOnly or NotRecursive iterator.
+     */
+    quint32 entryCount() const;
 
 private:
+    bool openDirectory(const QByteArray& path, bool followSymlink);
+    void closeDirectory();
+    bool statEntry(const char* name);
+    bool isReadable(const char* name) const;
+    bool shouldIndexFolder(const QString& fileName, bool hidden) const;
+    bool shouldIndexFile(const QString& fileName, bool hidden) const;
+
     const FileIndexerConfig* m_config;
+    Filter m_filter;
+    Recursion m_recursion;
+    bool m_indexHidden;
 
-    QDirIterator* m_currentIter;
-    QStack<QString> m_paths;
-    QDir::Filters m_filters;
+    DIR* m_dir;
+    QByteArray m_dirPath;
+    QString m_dirPathString;
+    // The st_dev of the open directory, and its filesystem id
+    dev_t m_dirDev;
+    dev_t m_dirFsid;
+    quint64 m_dirId;
+    QStack<QByteArray> m_paths;
 
     QString m_filePath;
-    QFileInfo m_fileInfo;
+    QT_STATBUF m_statBuf;
+    quint64 m_parentId;
+    // The name of the current entry, valid until the next readdir()
+    const char* m_entryName;
+    quint32 m_entryCount;
+    bool m_skipFileStat;
+    // The files of the open directory are returned without a stat
+    bool m_dirStatInodes;
+    bool m_hasStat;
+    bool m_isDir;
     bool m_firstItem;
+    // The folder the iteration starts with may be a symlink, its id is
+    // the one of the link, like filePathToId() gives it
+    bool m_followStart;
+    quint64 m_startId;
 };
 
 }
@@ -6,15 +6,19 @@
 
 #include "firstrunindexer.h"
 #include "basicindexingjob.h"
+#include "directorycrawler.h"
 #include "fileindexerconfig.h"
 #include "filtereddiriterator.h"
 
 #include "baloodebug.h"
+#include "bulkloader.h"
 #include "database.h"
 #include "transaction.h"
 
 #include <QMimeDatabase>
 
+#include <memory>
+
 using namespace Baloo;
 
 FirstRunIndexer::FirstRunIndexer(Database* db, FileIndexerConfig* config, const QStringList& folders)
@@ -29,25 +33,56 @@ FirstRunIndexer::FirstRunIndexer(Database* db, FileIndexerConfig* config, const
 
 void FirstRunIndexer::run()
 {
-    QMimeDatabase mimeDb;
     BasicIndexingJob::IndexingLevel level = m_config->onlyBasicIndexing() ? BasicIndexingJob::NoLevel
         : BasicIndexingJob::MarkForContentIndexing;
 
+    // On an empty index, the terms are collected and written at the end in one go
+    std::unique_ptr<BulkLoader> loader;
+    {
+        Transaction tr(m_db, Transaction::ReadOnly);
+        if (tr.size() == 0) {
+            loader = std::make_unique<BulkLoader>(BulkLoader::runDirectory(m_db->path()));
+            if (!loader->isValid()) {
+                loader.reset();
+            }
+        }
+    }
+
     for (const QString& folder : std::as_const(m_folders)) {
         Transaction tr(m_db, Transaction::ReadWrite);
+        tr.setBulkLoader(loader.get());
+        tr.setMemoryBudget(m_config->transactionMemoryBudget());
         int transactionDocumentCount = 0;
 
-        FilteredDirIterator it(m_config, folder);
-        while (!it.next().isEmpty()) {
-            QString mimetype;
-            if (it.fileInfo().isDir()) {
-                mimetype = QStringLiteral("inode/directory");
-            } else {
-                mimetype = mimeDb.mimeTypeForFile(it.filePath(), QMimeDatabase::MatchExtension).name();
-            }
+        DirectoryCrawler crawler(m_config, folder, m_config->crawlerThreadCount(), [level] {
+            auto mimeDb = std::make_shared<QMimeDatabase>();
+            auto process = [level, mimeDb](FilteredDirIterator& it, DirectoryCrawler::Item& item) {
+                QString mimetype;
+                if (it.isDir()) {
+                    mimetype = QStringLiteral("inode/directory");
+                } else {
+                    mimetype = mimeDb->mimeTypeForFile(it.filePath(), QMimeDatabase::MatchExtension).name();
+                }
 
-            BasicIndexingJob job(it.filePath(), mimetype, level);
-            if (!job.index()) {
+                BasicIndexingJob job(it.filePath(), mimetype, level);
+                job.setStatBuf(it.statBuf());
+                job.setParentId(it.parentId());
+                if (!job.index()) {
+                    return false;
+                }
+                item.document = job.document();
+                return true;
+            };
+            return DirectoryCrawler::Worker{process, {}};
+        });
+
+        DirectoryCrawler::Item item;
+        while (crawler.next(item)) {
+            if (item.folderId) {
+                // Lets the next rescan skip the stats of the unchanged folders
+                if (m_config->fastRescan()) {
+                    tr.setFolderFingerprint(item.folderId, item.fingerprint);
+                }
                 continue;
             }
 
@@ -56,11 +91,13 @@ void FirstRunIndexer::run()
             // Hence we are checking before.
             // FIXME: Silently ignore hard links!
             //
-            if (tr.hasDocument(job.document().id())) {
+            if (tr.hasDocument(item.document.id())) {
                 continue;
             }
-            tr.addDocument(job.document());
+            tr.addDocument(item.document);
 
+            // The memory budget bounds the pending posting list changes, the
+            // regular commits bound the size of the database transaction
             transactionDocumentCount++;
             if (transactionDocumentCount > 20000) {
                 qCDebug(BALOO) << "Commit";
@@ -70,11 +107,24 @@ void FirstRunIndexer::run()
             }
         }
 
-        // FIXME: This would consume too much memory. We should make some more commits
-        //        based on how much memory we consume
         tr.commit();
     }
 
+    if (loader) {
+        qCDebug(BALOO) << "Writing bulk loaded terms";
+        Transaction tr(m_db, Transaction::ReadWrite);
+        tr.setBulkLoader(loader.get());
+        if (!tr.finishBulkLoad()) {
+            // Keep the run directory, the index gets rebuilt on the next start
+            qCWarning(BALOO) << "Failed to write the bulk loaded terms";
+            if (tr.isActive()) {
+                tr.abort();
+            }
+        } else if (tr.commit()) {
+            loader->removeRunDirectory();
+        }
+    }
+
     Q_EMIT done();
 }
 
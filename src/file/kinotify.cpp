@@ -282,8 +282,8 @@ void KInotify::handleDirCreated(const QString& path)
         d->addWatch(it.filePath());
     }
     while (!it.next().isEmpty()) {
-        Q_EMIT created(it.filePath(), it.fileInfo().isDir());
-        if (it.fileInfo().isDir()) {
+        Q_EMIT created(it.filePath(), it.isDir());
+        if (it.isDir()) {
             d->addWatch(it.filePath());
         }
     }
@@ -11,6 +11,7 @@
 
 #include "global.h"
 #include "database.h"
+#include "bulkloader.h"
 #include "fileindexerconfig.h"
 #include "priority.h"
 #include "migrator.h"
@@ -18,6 +19,7 @@
 
 #include <QDBusConnection>
 #include <QCoreApplication>
+#include <QDir>
 #include <QFile>
 
 int main(int argc, char** argv)
@@ -51,6 +53,17 @@ int main(int argc, char** argv)
 
     bool firstRun = !QFile::exists(path + QStringLiteral("/index"));
 
+    // An interrupted first run leaves the bulk load run directory behind, the
+    // index is missing most of its terms then
+    const QString bulkLoadDir = Baloo::BulkLoader::runDirectory(path);
+    if (QFile::exists(bulkLoadDir)) {
+        qWarning() << "Previous initial indexing did not finish, removing the incomplete database.";
+        QFile::remove(path + QStringLiteral("/index"));
+        QFile::remove(path + QStringLiteral("/index-lock"));
+        QDir(bulkLoadDir).removeRecursively();
+        firstRun = true;
+    }
+
     Baloo::Database *db = Baloo::globalDatabaseInstance();
 
     /**
@@ -29,6 +29,11 @@ MainHub::MainHub(Database* db, FileIndexerConfig* config, bool firstRun)
 
     connect(&m_fileWatcher, &FileWatch::installedWatches, &m_fileIndexScheduler, &FileIndexScheduler::scheduleIndexing);
 
+    // The first run bulk loads the terms, and has to be the only writer
+    connect(&m_fileIndexScheduler, &FileIndexScheduler::stateChanged, this, [this](int state) {
+        m_fileWatcher.setMetadataUpdatesSuspended(state == FirstRun);
+    });
+
     QDBusConnection bus = QDBusConnection::sessionBus();
     bus.registerObject(QStringLiteral("/"), this, QDBusConnection::ExportAllSlots |
                         QDBusConnection::ExportScriptableSignals | QDBusConnection::ExportAdaptors);
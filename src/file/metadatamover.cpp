@@ -14,6 +14,8 @@
 
 #include <QFile>
 
+#include <utility>
+
 using namespace Baloo;
 
 MetadataMover::MetadataMover(Database* db, QObject* parent)
@@ -26,12 +28,37 @@ MetadataMover::~MetadataMover()
 {
 }
 
+void MetadataMover::setSuspended(bool suspended)
+{
+    if (suspended == m_suspended) {
+        return;
+    }
+    m_suspended = suspended;
+    if (suspended) {
+        return;
+    }
+
+    const QVector<PendingChange> changes = std::exchange(m_pendingChanges, {});
+    for (const PendingChange& change : changes) {
+        if (change.to.isEmpty()) {
+            removeFileMetadata(change.from);
+        } else {
+            moveFileMetadata(change.from, change.to);
+        }
+    }
+}
+
 void MetadataMover::moveFileMetadata(const QString& from, const QString& to)
 {
 //    qCDebug(BALOO) << from << to;
     Q_ASSERT(!from.isEmpty() && from != QLatin1String("/"));
     Q_ASSERT(!to.isEmpty() && to != QLatin1String("/"));
 
+    if (m_suspended) {
+        m_pendingChanges.append({from, to});
+        return;
+    }
+
     Transaction tr(m_db, Transaction::ReadWrite);
 
     // We do NOT get deleted messages for overwritten files! Thus, we
@@ -48,6 +75,11 @@ void MetadataMover::removeFileMetadata(const QString& file)
 {
     Q_ASSERT(!file.isEmpty() && file != QLatin1String("/"));
 
+    if (m_suspended) {
+        m_pendingChanges.append({file, QString()});
+        return;
+    }
+
     Transaction tr(m_db, Transaction::ReadWrite);
     removeMetadata(&tr, file);
     tr.commit();
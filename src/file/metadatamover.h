@@ -10,6 +10,7 @@
 #define BALOO_METADATA_MOVER_H_
 
 #include <QObject>
+#include <QVector>
 
 namespace Baloo
 {
@@ -25,6 +26,13 @@ public:
     explicit MetadataMover(Database* db, QObject* parent = nullptr);
     ~MetadataMover() override;
 
+    /**
+     * While suspended, the moves and removals are queued, and written in
+     * order on resume. The bulk loaded first run has to be the only writer
+     * of the term databases, see BulkLoader.
+     */
+    void setSuspended(bool suspended);
+
 public Q_SLOTS:
     void moveFileMetadata(const QString& from, const QString& to);
     void removeFileMetadata(const QString& file);
@@ -54,6 +62,14 @@ private:
     void updateMetadata(Transaction* tr, const QString& from, const QString& to);
 
     Database* m_db;
+
+    // An empty to marks a removal of from
+    struct PendingChange {
+        QString from;
+        QString to;
+    };
+    QVector<PendingChange> m_pendingChanges;
+    bool m_suspended = false;
 };
 }
 
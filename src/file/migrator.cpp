@@ -24,8 +24,11 @@ Migrator::Migrator(const QString& dbPath, FileIndexerConfig* config)
 /*
  * Changing this version number indicates that the old index should be deleted
  * and the indexing should be started from scratch.
+ *
+ * Version 3: delta encoded posting lists, see PostingCodec
+ * Version 4: posting lists split into blocks, with a block directory
  */
-static int s_dbVersion = 2;
+static int s_dbVersion = 4;
 
 bool Migrator::migrationRequired() const
 {
@@ -8,14 +8,13 @@
 #include "basicindexingjob.h"
 #include "fileindexerconfig.h"
 #include "idutils.h"
+#include "statcache.h"
 
 #include "database.h"
 #include "transaction.h"
 
 #include <QMimeDatabase>
 #include <QFile>
-#include <QFileInfo>
-#include <QDateTime>
 
 using namespace Baloo;
 
@@ -36,7 +35,9 @@ void ModifiedFileIndexer::run()
         : BasicIndexingJob::MarkForContentIndexing;
 
     Transaction tr(m_db, Transaction::ReadWrite);
+    tr.setMemoryBudget(m_config->transactionMemoryBudget());
 
+    StatCache statCache;
     for (const QString &path : m_files) {
         auto filePath = path;
         if (filePath.endsWith(QLatin1Char('/'))) {
@@ -48,14 +49,16 @@ void ModifiedFileIndexer::run()
             continue;
         }
 
-        quint64 fileId = filePathToId(QFile::encodeName(filePath));
+        QT_STATBUF statBuf;
+        if (statCache.stat(QFile::encodeName(filePath), statBuf) != 0) {
+            continue;
+        }
+        const quint64 fileId = statBufToId(statBuf);
         if (!fileId) {
             continue;
         }
 
-        // FIXME: Using QFileInfo over here is quite expensive!
-        QFileInfo fileInfo(filePath);
-        if (fileInfo.isSymLink()) {
+        if (S_ISLNK(statBuf.st_mode)) {
             continue;
         }
 
@@ -64,8 +67,8 @@ void ModifiedFileIndexer::run()
         const bool isKnownFile = tr.hasDocument(fileId);
         if (isKnownFile) {
             DocumentTimeDB::TimeInfo timeInfo = tr.documentTimeInfo(fileId);
-            mTimeChanged = timeInfo.mTime != fileInfo.lastModified().toSecsSinceEpoch();
-            cTimeChanged = timeInfo.cTime != fileInfo.metadataChangeTime().toSecsSinceEpoch();
+            mTimeChanged = timeInfo.mTime != static_cast<quint32>(statBuf.st_mtime);
+            cTimeChanged = timeInfo.cTime != static_cast<quint32>(statBuf.st_ctime);
         } else {
             mTimeChanged = cTimeChanged = true;
         }
@@ -75,7 +78,7 @@ void ModifiedFileIndexer::run()
         }
 
         QString mimetype;
-        if (fileInfo.isDir()) {
+        if (S_ISDIR(statBuf.st_mode)) {
             // The folder ctime changes when the folder is created, when the folder is
             // renamed, or when the xattrs (tags, comments, ...) change
             if (!cTimeChanged) {
@@ -91,8 +94,8 @@ void ModifiedFileIndexer::run()
         if (!cTimeChanged) {
             Document doc;
             doc.setId(fileId);
-            doc.setMTime(fileInfo.lastModified().toSecsSinceEpoch());
-            doc.setCTime(fileInfo.metadataChangeTime().toSecsSinceEpoch());
+            doc.setMTime(statBuf.st_mtime);
+            doc.setCTime(statBuf.st_ctime);
             if (level == BasicIndexingJob::MarkForContentIndexing) {
                 doc.setContentIndexing(true);
             }
@@ -102,6 +105,8 @@ void ModifiedFileIndexer::run()
         }
 
         BasicIndexingJob job(filePath, mimetype, level);
+        job.setStatBuf(statBuf);
+        job.setStatCache(&statCache);
         if (!job.index()) {
             continue;
         }
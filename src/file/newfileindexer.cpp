@@ -7,12 +7,13 @@
 #include "newfileindexer.h"
 #include "basicindexingjob.h"
 #include "fileindexerconfig.h"
+#include "statcache.h"
 
 #include "database.h"
 #include "transaction.h"
 
 #include <QMimeDatabase>
-#include <QFileInfo>
+#include <QFile>
 
 using namespace Baloo;
 
@@ -33,7 +34,10 @@ void NewFileIndexer::run()
         : BasicIndexingJob::MarkForContentIndexing;
 
     Transaction tr(m_db, Transaction::ReadWrite);
+    tr.setMemoryBudget(m_config->transactionMemoryBudget());
 
+    // The new files mostly come in batches from the same folders
+    StatCache statCache;
     for (const QString &path : m_files) {
         auto filePath = path;
         if (filePath.endsWith(QLatin1Char('/'))) {
@@ -41,13 +45,16 @@ void NewFileIndexer::run()
         }
 
         QString mimetype;
-        QFileInfo fileInfo(filePath);
+        QT_STATBUF statBuf;
+        if (statCache.stat(QFile::encodeName(filePath), statBuf) != 0) {
+            continue;
+        }
 
-        if (fileInfo.isSymLink()) {
+        if (S_ISLNK(statBuf.st_mode)) {
             continue;
         }
 
-        if (fileInfo.isDir()) {
+        if (S_ISDIR(statBuf.st_mode)) {
             if (!m_config->shouldFolderBeIndexed(filePath)) {
                 continue;
             }
@@ -62,6 +69,8 @@ void NewFileIndexer::run()
         }
 
         BasicIndexingJob job(filePath, mimetype, level);
+        job.setStatBuf(statBuf);
+        job.setStatCache(&statCache);
         if (!job.index()) {
             continue;
         }
@@ -0,0 +1,62 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "statcache.h"
+#include "idutils.h"
+
+using namespace Baloo;
+
+namespace {
+// Bounds the memory of long batches, a crawl only needs the recent folders
+constexpr int MaxCachedFolders = 10000;
+}
+
+int StatCache::stat(const QByteArray& filePath, QT_STATBUF& statBuf)
+{
+#ifndef Q_OS_WIN
+    const int ret = QT_LSTAT(filePath.constData(), &statBuf);
+    if (ret != 0) {
+        return ret;
+    }
+
+    const quint64 dev = statBuf.st_dev;
+    auto it = m_fsids.constFind(dev);
+    if (it == m_fsids.constEnd()) {
+        // Same as statWithFsid(), the device id is kept if there is no
+        // filesystem id
+        struct statvfs fsBuf;
+        if (statvfs(filePath.constData(), &fsBuf) != 0) {
+            return -1;
+        }
+        it = m_fsids.insert(dev, fsBuf.f_fsid != 0 ? foldFsid(fsBuf.f_fsid) : dev);
+    }
+    statBuf.st_dev = *it;
+    return 0;
+#else
+    return filePathToStat(filePath, statBuf);
+#endif
+}
+
+quint64 StatCache::folderId(const QByteArray& folderPath)
+{
+    auto it = m_folderIds.constFind(folderPath);
+    if (it != m_folderIds.constEnd()) {
+        return *it;
+    }
+
+    QT_STATBUF statBuf;
+    if (stat(folderPath, statBuf) != 0) {
+        return 0;
+    }
+
+    if (m_folderIds.size() >= MaxCachedFolders) {
+        m_folderIds.clear();
+    }
+    const quint64 id = statBufToId(statBuf);
+    m_folderIds.insert(folderPath, id);
+    return id;
+}
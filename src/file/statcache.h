@@ -0,0 +1,49 @@
+/*
+    This file is part of the KDE Baloo project.
+    SPDX-FileCopyrightText: 2026 KDE Baloo Developers
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef BALOO_STATCACHE_H
+#define BALOO_STATCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+
+#include <qplatformdefs.h>
+
+namespace Baloo {
+
+/**
+ * Caches the ids of the folders and the filesystem ids of the devices
+ * for the duration of a crawl or a batch of files. A file in a known
+ * folder then takes a single lstat() instead of the four syscalls of
+ * filePathToStat() on the file and its folder.
+ *
+ * The cache is not thread safe, each indexer run has its own. Folders
+ * replaced or mounts changed during its lifetime are not noticed.
+ */
+class StatCache
+{
+public:
+    /**
+     * Same as filePathToStat(), the filesystem id is fetched once
+     * per device
+     */
+    int stat(const QByteArray& filePath, QT_STATBUF& statBuf);
+
+    /**
+     * The id of the folder, same as filePathToId(). 0 if the folder
+     * cannot be stat'ed
+     */
+    quint64 folderId(const QByteArray& folderPath);
+
+private:
+    QHash<quint64, quint64> m_fsids;
+    QHash<QByteArray, quint64> m_folderIds;
+};
+
+}
+
+#endif // BALOO_STATCACHE_H
@@ -8,13 +8,35 @@
 #include "unindexedfileindexer.h"
 
 #include "unindexedfileiterator.h"
+#include "directorycrawler.h"
 #include "transaction.h"
 #include "fileindexerconfig.h"
 #include "baloodebug.h"
 #include "basicindexingjob.h"
+#include "idutils.h"
+
+#include <QDateTime>
+#include <QFile>
+
+#include <memory>
 
 using namespace Baloo;
 
+namespace {
+struct WorkerState {
+    explicit WorkerState(Database* db)
+        : tr(db, Transaction::ReadOnly)
+        , timeLookup(&tr)
+    {
+    }
+
+    Transaction tr;
+    IndexedTimeLookup timeLookup;
+    QMimeDatabase mimeDb;
+    int entryCount = 0;
+};
+}
+
 UnindexedFileIndexer::UnindexedFileIndexer(Database* db, const FileIndexerConfig* config)
     : m_db(db)
     , m_config(config)
@@ -27,37 +49,101 @@ void UnindexedFileIndexer::run()
     const BasicIndexingJob::IndexingLevel level = m_config->onlyBasicIndexing() ?
         BasicIndexingJob::NoLevel : BasicIndexingJob::MarkForContentIndexing;
 
+    // The files of an unchanged folder are only stat'ed when they were
+    // modified recently, older files are assumed to be left as they are
+    const bool fastRescan = m_config->fastRescan();
+    const qint64 recentLimit = QDateTime::currentSecsSinceEpoch() - qint64(m_config->fastRescanRecentDays()) * 24 * 60 * 60;
+
     for (const QString& includeFolder : includeFolders) {
         Transaction tr(m_db, Transaction::ReadWrite);
+        tr.setMemoryBudget(m_config->transactionMemoryBudget());
         int transactionDocumentCount = 0;
 
-        UnIndexedFileIterator it(m_config, &tr, includeFolder);
-        while (!it.next().isEmpty()) {
-            BasicIndexingJob job(it.filePath(), it.mimetype(), level);
-            if (!job.index()) {
-                continue;
-            }
+        DirectoryCrawler crawler(m_config, includeFolder, m_config->crawlerThreadCount(), [this, level, fastRescan, recentLimit] {
+            // The times are compared in a read transaction per worker, renewed
+            // now and then so it does not keep the old pages of the database
+            auto state = std::make_shared<WorkerState>(m_db);
+            auto process = [level, state, recentLimit](FilteredDirIterator& it, DirectoryCrawler::Item& item) {
+                if (++state->entryCount % 1000 == 0) {
+                    state->tr.abort();
+                    state->tr.reset(Transaction::ReadOnly);
+                }
 
-            if (it.mTimeChanged() && level == BasicIndexingJob::MarkForContentIndexing) {
-                job.document().setContentIndexing(true);
-            }
+                if (!it.hasStat()) {
+                    DocumentTimeDB::TimeInfo timeInfo;
+                    if (state->timeLookup.timeInfo(it.parentId(), statBufToId(it.statBuf()), timeInfo)
+                        && timeInfo.mTime < recentLimit) {
+                        return false;
+                    }
+                    if (!it.stat()) {
+                        return false;
+                    }
+                }
 
-            // We handle modified files by simply updating the mTime and filename in the Db and marking them for ContentIndexing
-            const quint64 id = job.document().id();
-            if (tr.hasDocument(id)) {
-                DocumentOperations ops = DocumentTime;
-                if (it.cTimeChanged()) {
-                    ops |= XAttrTerms;
-                    if (QFile::decodeName(tr.documentUrl(id)) != it.filePath()) {
-                        ops |= (FileNameTerms | DocumentUrl);
+                QString mimetype;
+                bool mTimeChanged;
+                bool cTimeChanged;
+                if (!UnIndexedFileIterator::shouldIndex(state->timeLookup, it, state->mimeDb, mimetype, mTimeChanged, cTimeChanged)) {
+                    return false;
+                }
+
+                BasicIndexingJob job(it.filePath(), mimetype, level);
+                job.setStatBuf(it.statBuf());
+                job.setParentId(it.parentId());
+                if (!job.index()) {
+                    return false;
+                }
+                item.document = job.document();
+
+                if (mTimeChanged && level == BasicIndexingJob::MarkForContentIndexing) {
+                    item.document.setContentIndexing(true);
+                }
+
+                // We handle modified files by simply updating the mTime and filename in the Db and marking them for ContentIndexing
+                const quint64 id = item.document.id();
+                if (state->tr.hasDocument(id)) {
+                    item.operations = DocumentTime;
+                    if (cTimeChanged) {
+                        item.operations |= XAttrTerms;
+                        if (QFile::decodeName(state->tr.documentUrl(id)) != it.filePath()) {
+                            item.operations |= (FileNameTerms | DocumentUrl);
+                        }
                     }
                 }
-                tr.replaceDocument(job.document(), ops);
+                return true;
+            };
 
-            } else { // New file
-                tr.addDocument(job.document());
+            if (!fastRescan) {
+                return DirectoryCrawler::Worker{process, {}};
+            }
+            auto unchanged = [state](const QT_STATBUF& folderStat, FolderFingerprintDB::Fingerprint& fingerprint) {
+                return state->tr.folderFingerprint(statBufToId(folderStat), fingerprint)
+                    && fingerprint.mTime == quint32(folderStat.st_mtime)
+                    && fingerprint.cTime == quint32(folderStat.st_ctime);
+            };
+            return DirectoryCrawler::Worker{process, unchanged};
+        });
+
+        DirectoryCrawler::Item item;
+        while (crawler.next(item)) {
+            if (item.folderId) {
+                if (fastRescan) {
+                    tr.setFolderFingerprint(item.folderId, item.fingerprint);
+                }
+                continue;
+            }
+
+            if (!tr.hasDocument(item.document.id())) { // New file
+                tr.addDocument(item.document);
+            } else if (item.operations) {
+                tr.replaceDocument(item.document, item.operations);
+            } else {
+                // A hard link of a new file, which has been added already
+                continue;
             }
 
+            // The memory budget bounds the pending posting list changes, the
+            // regular commits bound the size of the database transaction
             transactionDocumentCount++;
             if (transactionDocumentCount > 20000) {
                 qCDebug(BALOO) << "Commit";
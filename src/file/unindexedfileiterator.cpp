@@ -11,14 +11,39 @@
 #include "transaction.h"
 #include "baloodebug.h"
 
-#include <QFileInfo>
-#include <QDateTime>
+#include <algorithm>
 
 using namespace Baloo;
 
+IndexedTimeLookup::IndexedTimeLookup(Transaction* transaction)
+    : m_transaction(transaction)
+    , m_parentId(0)
+{
+}
+
+bool IndexedTimeLookup::timeInfo(quint64 parentId, quint64 id, DocumentTimeDB::TimeInfo& timeInfo)
+{
+    if (parentId && parentId != m_parentId) {
+        m_parentId = parentId;
+        m_transaction->folderTimeInfo(parentId, m_ids, m_timeInfos);
+    }
+
+    if (parentId) {
+        auto it = std::lower_bound(m_ids.cbegin(), m_ids.cend(), id);
+        if (it != m_ids.cend() && *it == id) {
+            timeInfo = m_timeInfos[it - m_ids.cbegin()];
+            return true;
+        }
+    }
+
+    // Not indexed, or indexed in another folder
+    timeInfo = m_transaction->documentTimeInfo(id);
+    return timeInfo.mTime != 0 || timeInfo.cTime != 0 || m_transaction->hasDocument(id);
+}
+
 UnIndexedFileIterator::UnIndexedFileIterator(const FileIndexerConfig* config, Transaction* transaction, const QString& folder)
     : m_config(config)
-    , m_transaction(transaction)
+    , m_timeLookup(transaction)
     , m_iter(config, folder, FilteredDirIterator::FilesAndDirs)
     , m_mTimeChanged(false)
     , m_cTimeChanged(false)
@@ -61,45 +86,43 @@ QString UnIndexedFileIterator::next()
             return QString();
         }
 
-        if (shouldIndex(filePath)) {
+        if (shouldIndex(m_timeLookup, m_iter, m_mimeDb, m_mimetype, m_mTimeChanged, m_cTimeChanged)) {
             return filePath;
         }
     }
 }
 
-bool UnIndexedFileIterator::shouldIndex(const QString& filePath)
+bool UnIndexedFileIterator::shouldIndex(IndexedTimeLookup& timeLookup, const FilteredDirIterator& iter, QMimeDatabase& mimeDb,
+                                        QString& mimetype, bool& mTimeChanged, bool& cTimeChanged)
 {
-    const QFileInfo fileInfo = m_iter.fileInfo();
-    if (!fileInfo.exists()) {
-        return false;
-    }
-
-    quint64 fileId = filePathToId(QFile::encodeName(filePath));
-    if (!fileId) {
-        // stat has failed, e.g. when file has been deleted after iteration
-        return false;
-    }
-
-    DocumentTimeDB::TimeInfo timeInfo = m_transaction->documentTimeInfo(fileId);
-    if ((timeInfo.mTime == 0) && (timeInfo.cTime == 0) && !m_transaction->hasDocument(fileId)) {
-        m_mTimeChanged = true;
-        m_cTimeChanged = true;
+    const QString filePath = iter.filePath();
+    const QT_STATBUF& statBuf = iter.statBuf();
+    const quint64 fileId = statBufToId(statBuf);
+    const quint32 mTime = statBuf.st_mtime;
+    const quint32 cTime = statBuf.st_ctime;
+    mTimeChanged = false;
+    cTimeChanged = false;
+
+    DocumentTimeDB::TimeInfo timeInfo;
+    if (!timeLookup.timeInfo(iter.parentId(), fileId, timeInfo)) {
+        mTimeChanged = true;
+        cTimeChanged = true;
     } else {
-        if (timeInfo.mTime != fileInfo.lastModified().toSecsSinceEpoch()) {
-            m_mTimeChanged = true;
+        if (timeInfo.mTime != mTime) {
+            mTimeChanged = true;
         }
-        if (timeInfo.cTime != fileInfo.metadataChangeTime().toSecsSinceEpoch()) {
-            m_cTimeChanged = true;
+        if (timeInfo.cTime != cTime) {
+            cTimeChanged = true;
         }
     }
 
-    if (fileInfo.isDir()) {
+    if (iter.isDir()) {
         // The folder ctime changes when the file is created, when the folder is
         // renamed, or when the xattrs (tags, comments, ...) change
-        if (m_cTimeChanged) {
+        if (cTimeChanged) {
             qCDebug(BALOO) << filePath << "ctime changed:"
-                << timeInfo.cTime << "->" << fileInfo.metadataChangeTime().toSecsSinceEpoch();
-            m_mimetype = QStringLiteral("inode/directory");
+                << timeInfo.cTime << "->" << cTime;
+            mimetype = QStringLiteral("inode/directory");
             return true;
         }
         // The mtime changes when an object inside the folder is added/removed/renamed,
@@ -107,18 +130,22 @@ bool UnIndexedFileIterator::shouldIndex(const QString& filePath)
         return false;
     }
 
-    if (m_mTimeChanged || m_cTimeChanged) {
+    if (mTimeChanged || cTimeChanged) {
         // This mimetype may not be completely accurate, but that's okay. This is
         // just the initial phase of indexing. The second phase can try to find
         // a more accurate mimetype.
-        m_mimetype = m_mimeDb.mimeTypeForFile(filePath, QMimeDatabase::MatchExtension).name();
+        mimetype = mimeDb.mimeTypeForFile(filePath, QMimeDatabase::MatchExtension).name();
 
         qCDebug(BALOO) << filePath << "mtime/ctime changed:"
             << timeInfo.mTime << "/" << timeInfo.cTime << "->"
-            << fileInfo.lastModified().toSecsSinceEpoch() << "/"
-            << fileInfo.metadataChangeTime().toSecsSinceEpoch();
+            << mTime << "/" << cTime;
         return true;
     }
 
     return false;
 }
+
+const QT_STATBUF& UnIndexedFileIterator::statBuf() const
+{
+    return m_iter.statBuf();
+}
@@ -9,6 +9,7 @@
 #define BALOO_UNINDEXEDFILEITERATOR_H
 
 #include "filtereddiriterator.h"
+#include "documenttimedb.h"
 
 #include <QMimeDatabase>
 
@@ -16,6 +17,31 @@ namespace Baloo {
 
 class Transaction;
 
+/**
+ * Looks up the indexed times of the files of a crawl. The documents of a
+ * folder and their times are loaded in one go on its first file, as the
+ * files of a folder come in a row. The other files of the folder are then
+ * found in memory instead of two database lookups each.
+ */
+class IndexedTimeLookup
+{
+public:
+    explicit IndexedTimeLookup(Transaction* transaction);
+
+    /**
+     * The indexed times of \p id in the folder \p parentId, returns false
+     * if \p id is not indexed. A \p parentId of 0 and the files moved
+     * from another folder are looked up on their own.
+     */
+    bool timeInfo(quint64 parentId, quint64 id, DocumentTimeDB::TimeInfo& timeInfo);
+
+private:
+    Transaction* m_transaction;
+    quint64 m_parentId;
+    QVector<quint64> m_ids;
+    QVector<DocumentTimeDB::TimeInfo> m_timeInfos;
+};
+
 /**
  * Iterate over all the files (and directories) under a specific directory which require
  * indexing. This checks the following -
@@ -36,11 +62,23 @@ public:
     bool mTimeChanged() const;
     bool cTimeChanged() const;
 
+    /**
+     * The stat of the current file, see FilteredDirIterator::statBuf()
+     */
+    const QT_STATBUF& statBuf() const;
+
+    /**
+     * Compares the times of the current entry of \p iter with the ones in the
+     * database, as next() does. Sets the changes and the mimetype of the entry
+     * if it requires indexing.
+     */
+    static bool shouldIndex(IndexedTimeLookup& timeLookup, const FilteredDirIterator& iter, QMimeDatabase& mimeDb,
+                            QString& mimetype, bool& mTimeChanged, bool& cTimeChanged);
+
 private:
-    bool shouldIndex(const QString& filePath);
 
     const FileIndexerConfig* m_config;
-    Transaction* m_transaction;
+    IndexedTimeLookup m_timeLookup;
     FilteredDirIterator m_iter;
 
     QMimeDatabase m_mimeDb;
@@ -7,6 +7,7 @@
 #include "xattrindexer.h"
 #include "basicindexingjob.h"
 #include "fileindexerconfig.h"
+#include "statcache.h"
 
 #include "database.h"
 #include "transaction.h"
@@ -33,6 +34,7 @@ void XAttrIndexer::run()
 
     Transaction tr(m_db, Transaction::ReadWrite);
 
+    StatCache statCache;
     for (const QString &path : m_files) {
         auto filePath = path;
         if (filePath.endsWith(QLatin1Char('/'))) {
@@ -48,6 +50,7 @@ void XAttrIndexer::run()
 
         // FIXME: The BasicIndexingJob extracts too much info. We only need the xattr
         BasicIndexingJob job(filePath, mimetype, BasicIndexingJob::NoLevel);
+        job.setStatCache(&statCache);
         if (!job.index()) {
             continue;
         }
@@ -15,6 +15,8 @@
 #include <QTemporaryDir>
 #include <QElapsedTimer>
 
+#include <sys/resource.h>
+
 using namespace Baloo;
 
 int main(int argc, char** argv)
@@ -34,11 +36,19 @@ int main(int argc, char** argv)
     QElapsedTimer timer;
     timer.start();
 
+    int num = 0;
     UnIndexedFileIterator it(&config, &tr, QDir::homePath());
     while (!it.next().isEmpty()) {
-        ;
+        num++;
     }
 
-    qDebug() << "Done" << timer.elapsed() << "msecs";
+    qDebug() << "Done" << num << "files in" << timer.elapsed() << "msecs";
+
+    // The system time is mostly the directory reading and stat calls
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        qDebug() << "User" << usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000 << "msecs,"
+                 << "System" << usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000 << "msecs";
+    }
     return 0;
 }
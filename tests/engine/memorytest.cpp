@@ -10,9 +10,15 @@
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QDataStream>
+#include <QElapsedTimer>
 
 #include "document.h"
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
 int main(int argc, char** argv)
 {
     QCoreApplication app(argc, argv);
@@ -20,6 +26,8 @@ int main(int argc, char** argv)
     QCommandLineParser parser;
     parser.addPositionalArgument(QStringLiteral("num"), QStringLiteral("The number of terms. Each term is of length 10"));
     parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("p") << QStringLiteral("position"), QStringLiteral("Add positional information")));
+    parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("r") << QStringLiteral("repeat"),
+                                        QStringLiteral("Add each term this many times, like words in a text"), QStringLiteral("count"), QStringLiteral("1")));
     parser.addHelpOption();
     parser.process(app);
 
@@ -28,22 +36,47 @@ int main(int argc, char** argv)
         parser.showHelp(1);
     }
 
-    Baloo::Document doc;
     int size = args.first().toInt();
+    const int repeat = qMax(1, parser.value(QStringLiteral("r")).toInt());
 
+    QVector<QByteArray> terms;
+    terms.reserve(size);
     for (int i = 0; i < size; i++) {
-        QByteArray term = QUuid::createUuid().toByteArray().mid(1, 10);
+        terms << QUuid::createUuid().toByteArray().mid(1, 10);
+    }
 
-        if (parser.isSet(QStringLiteral("p"))) {
-            doc.addPositionTerm(term, i);
-        }
-        else {
-            doc.addTerm(term);
+    QElapsedTimer timer;
+    timer.start();
+
+    Baloo::Document doc;
+    int position = 0;
+    for (int r = 0; r < repeat; r++) {
+        for (const QByteArray& term : std::as_const(terms)) {
+            if (parser.isSet(QStringLiteral("p"))) {
+                doc.addPositionTerm(term, position++);
+            }
+            else {
+                doc.addTerm(term);
+            }
         }
     }
 
-    qDebug() << "Added" << size << "terms";
+    // Serializing reads all the terms, like the transaction does
+    QByteArray serialized;
+    QDataStream stream(&serialized, QIODevice::WriteOnly);
+    stream << doc;
+
+    qDebug() << "Added" << size << "terms" << repeat << "times in" << timer.elapsed() << "ms";
     if (parser.isSet(QStringLiteral("p"))) {
         qDebug() << "With Positional Information";
     }
+    qDebug() << "Serialized size:" << serialized.size() << "bytes";
+
+#ifdef Q_OS_UNIX
+    // The terms generated above are included, run with a small count for the baseline
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        qDebug() << "Peak memory:" << usage.ru_maxrss << "KiB";
+    }
+#endif
 }
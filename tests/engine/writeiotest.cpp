@@ -7,12 +7,15 @@
 
 #include <QDebug>
 #include <QTemporaryDir>
-#include <QUuid>
 #include <QFileInfo>
 #include <QDir>
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <unistd.h>
 
 #include "database.h"
 #include "document.h"
@@ -24,8 +27,15 @@ int main(int argc, char** argv)
     QCoreApplication app(argc, argv);
 
     QCommandLineParser parser;
-    parser.addPositionalArgument(QStringLiteral("num"), QStringLiteral("The number of terms. Each term is of length 10"));
+    parser.addPositionalArgument(QStringLiteral("num"), QStringLiteral("The number of terms per document. Each term is of length 10"));
     parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("p") << QStringLiteral("position"), QStringLiteral("Add positional information")));
+    parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("d") << QStringLiteral("documents"),
+                                        QStringLiteral("The number of documents per commit"), QStringLiteral("count"), QStringLiteral("1")));
+    parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("c") << QStringLiteral("commits"),
+                                        QStringLiteral("The number of commits"), QStringLiteral("count"), QStringLiteral("1")));
+    parser.addOption(QCommandLineOption(QStringList () << QStringLiteral("s") << QStringLiteral("seed"),
+                                        QStringLiteral("The seed for the generated terms, the same seed gives the same documents"),
+                                        QStringLiteral("seed"), QStringLiteral("1")));
     parser.addHelpOption();
     parser.process(app);
 
@@ -42,28 +52,70 @@ int main(int argc, char** argv)
 
     qDebug() << tempDir.path();
     printIOUsage();
-    qDebug() << "Creating the document";
 
-    Baloo::Document doc;
-    int size = args.first().toInt();
+    const int size = args.first().toInt();
+    const int docsPerCommit = parser.value(QStringLiteral("d")).toInt();
+    const int commits = parser.value(QStringLiteral("c")).toInt();
+    const bool positions = parser.isSet(QStringLiteral("p"));
 
-    for (int i = 0; i < size; i++) {
-        QByteArray term = QUuid::createUuid().toByteArray().mid(1, 10);
+    // The same documents on every run, so the results of two builds can be compared
+    QRandomGenerator random(parser.value(QStringLiteral("s")).toUInt());
 
-        if (parser.isSet(QStringLiteral("p"))) {
-            doc.addPositionTerm(term, i);
-        }
-        else {
-            doc.addTerm(term);
+    // The documents share their terms, so later commits modify existing posting lists
+    QVector<QByteArray> vocabulary;
+    for (int i = 0; i < size * 10; i++) {
+        QByteArray term(10, 'a');
+        for (char& c : term) {
+            c = 'a' + random.bounded(26);
         }
+        vocabulary << term;
     }
-    doc.setParentId(1);
-    doc.setId(2);
 
-    Baloo::Transaction tr(db, Baloo::Transaction::ReadWrite);
-    tr.addDocument(doc);
-    tr.commit();
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    quint64 id = 2;
+    qint64 totalTime = 0;
+    qulonglong totalPages = 0;
+
+    for (int c = 0; c < commits; c++) {
+        Baloo::Transaction tr(db, Baloo::Transaction::ReadWrite);
+
+        for (int d = 0; d < docsPerCommit; d++) {
+            Baloo::Document doc;
+            // Present in every document, like the mimetype terms
+            doc.addTerm("Mtext/plain");
+            for (int i = 0; i < size; i++) {
+                const QByteArray& term = vocabulary[random.bounded(vocabulary.size())];
+
+                if (positions) {
+                    doc.addPositionTerm(term, i);
+                }
+                else {
+                    doc.addTerm(term);
+                }
+            }
+            doc.setUrl("/file" + QByteArray::number(id));
+            doc.setParentId(1);
+            doc.setId(id++);
+
+            tr.addDocument(doc);
+        }
+
+        const qulonglong writtenBefore = writtenBytes();
+        QElapsedTimer timer;
+        timer.start();
+
+        tr.commit();
+
+        const qint64 elapsed = timer.elapsed();
+        // LMDB writes every dirty page once when committing
+        const qulonglong pages = (writtenBytes() - writtenBefore) / pageSize;
+        qDebug() << "Commit" << c + 1 << ":" << elapsed << "ms," << pages << "pages written";
+
+        totalTime += elapsed;
+        totalPages += pages;
+    }
 
+    qDebug() << "Total commit time:" << totalTime << "ms," << totalPages << "pages written";
     printIOUsage();
 
     int dbSize = 0;
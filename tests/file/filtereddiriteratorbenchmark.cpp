@@ -8,10 +8,12 @@
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QElapsedTimer>
+#include <QFileInfo>
 #include <iostream>
 
 #include "filtereddiriterator.h"
 #include "fileindexerconfig.h"
+#include "idutils.h"
 #include "util.h"
 
 using namespace Baloo;
@@ -37,17 +39,27 @@ int main(int argc, char** argv)
     QElapsedTimer timer;
     timer.start();
 
+    // The ids are what the indexers need from every file, they come from
+    // the stat done by the iterator
     int num = 0;
+    int dirs = 0;
+    quint64 idSum = 0;
     for (const QString& dir : includeFolders) {
         FilteredDirIterator it(config.get(), dir);
         while (!it.next().isEmpty()) {
             num++;
+            if (it.isDir()) {
+                dirs++;
+            }
+            idSum += statBufToId(it.statBuf());
         }
     }
 
-    std::cout << "Num Files: " << num << std::endl;
+    std::cout << "Num Files: " << num << " (" << dirs << " folders)" << std::endl;
     std::cout << "Elapsed: " << timer.elapsed() << std::endl;
+    Q_UNUSED(idSum);
     printIOUsage();
+    printCpuUsage();
 
     return 0;
 }
@@ -11,6 +11,43 @@
 #include <QDebug>
 #include <QFile>
 
+#include <sys/resource.h>
+
+/**
+ * The number of bytes written by this process so far, including writes
+ * which did not reach the disk yet.
+ */
+inline qulonglong writtenBytes()
+{
+    QFile file(QStringLiteral("/proc/self/io"));
+    file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+    const QString wchar(QStringLiteral("wchar: "));
+    QTextStream fs(&file);
+    while (!fs.atEnd()) {
+        const QString line = fs.readLine();
+        if (line.startsWith(wchar)) {
+            return QStringView(line).mid(wchar.size()).toULongLong();
+        }
+    }
+    return 0;
+}
+
+/**
+ * Prints the user and system time, the system time shows the cost of
+ * the syscalls, e.g. one stat per file
+ */
+inline void printCpuUsage()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return;
+    }
+    qDebug() << "------- CPU --------";
+    qDebug() << "User:" << usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000 << "ms";
+    qDebug() << "System:" << usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000 << "ms";
+}
+
 inline void printIOUsage()
 {
     // Print the io usage
@@ -39,6 +76,11 @@ inline void printIOUsage()
             qDebug() << "Write:" << amount / 1024  << "kb";
         }
 
+        const QString syscr(QStringLiteral("syscr: "));
+        if (str.startsWith(syscr)) {
+            qDebug() << "Read syscalls:" << str.mid(syscr.size()).toULong();
+        }
+
         const QString read(QStringLiteral("read_bytes: "));
         if (str.startsWith(read)) {
             const ulong amount = str.mid(read.size()).toULong();